@@ -0,0 +1,58 @@
+#include <sbs/sbs.hpp>
+
+#include <sbs/serializers/vector.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+template <class Function>
+double best_seconds(const int iterations, Function&& function)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+template <class Type>
+void benchmark(const std::string& name, const size_t count)
+{
+    constexpr int iterations = 10;
+    std::vector<Type> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = static_cast<Type>(i * 2654435761U);
+    }
+    const double megabytes = static_cast<double>(count * sizeof(Type)) / (1024.0 * 1024.0);
+
+    for (const std::endian endian : { std::endian::little, std::endian::big }) {
+        const bool native = endian == std::endian::native;
+        std::vector<std::byte> bytes;
+        const double serialize_seconds
+            = best_seconds(iterations, [&] { bytes = sbs::serialize_to_vector(values, endian); });
+        std::vector<Type> values_out;
+        const double deserialize_seconds
+            = best_seconds(iterations, [&] { sbs::deserialize_from_span(bytes, values_out, endian); });
+        if (values_out != values) {
+            std::cerr << "Round trip mismatch for " << name << std::endl;
+        }
+        std::cout << name << (native ? " native " : " swapped") << "  serialize: " << megabytes / serialize_seconds
+                  << " MB/s  deserialize: " << megabytes / deserialize_seconds << " MB/s\n";
+    }
+}
+
+int main()
+{
+    constexpr size_t count = 16 * 1024 * 1024;
+    benchmark<uint16_t>("vector<uint16_t>", count);
+    benchmark<uint32_t>("vector<uint32_t>", count);
+    benchmark<double>("vector<double>  ", count);
+}
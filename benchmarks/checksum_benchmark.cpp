@@ -0,0 +1,60 @@
+#include <sbs/checksum.hpp>
+#include <sbs/sbs.hpp>
+
+#include <sbs/serializers/vector.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+template <class Function>
+double best_seconds(const int iterations, Function&& function)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+int main()
+{
+    constexpr int iterations = 10;
+    constexpr size_t count = 16 * 1024 * 1024;
+    std::vector<uint64_t> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = i * 0x9e3779b97f4a7c15ULL;
+    }
+    const std::span<const std::byte> bytes = std::as_bytes(std::span(values));
+    const double megabytes = static_cast<double>(bytes.size()) / (1024.0 * 1024.0);
+
+    uint32_t checksum = 0;
+    const double crc_seconds = best_seconds(iterations, [&] {
+        sbs::Crc32c crc;
+        crc.update(bytes);
+        checksum = crc.value();
+    });
+    const double software_seconds = best_seconds(
+        iterations, [&] { checksum ^= sbs::detail::crc32c_software(0xffffffff, bytes); });
+    std::cout << "crc32c: " << megabytes / crc_seconds << " MB/s  slicing-by-8: " << megabytes / software_seconds
+              << " MB/s\n";
+
+    std::vector<std::byte> plain;
+    const double plain_seconds = best_seconds(iterations, [&] { plain = sbs::serialize_to_vector(values); });
+    std::vector<std::byte> checksummed;
+    const double checksummed_seconds
+        = best_seconds(iterations, [&] { checksummed = sbs::serialize_checksummed_to_vector(values); });
+    std::vector<uint64_t> values_out;
+    const double verify_seconds
+        = best_seconds(iterations, [&] { sbs::deserialize_checksummed_from_span(checksummed, values_out); });
+    std::cout << "serialize: " << megabytes / plain_seconds << " MB/s  checksummed: "
+              << megabytes / checksummed_seconds << " MB/s  verified deserialize: " << megabytes / verify_seconds
+              << " MB/s\n";
+    return checksum == 0 ? 1 : 0;
+}
@@ -0,0 +1,53 @@
+#include <sbs/compression.hpp>
+#include <sbs/sbs.hpp>
+
+#include <sbs/serializers/vector.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+template <class Function>
+double best_seconds(const int iterations, Function&& function)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+int main()
+{
+    constexpr int iterations = 5;
+    constexpr size_t count = 32 * 1024 * 1024;
+    // Redundant like a typical snapshot: slowly changing counters with occasional jumps.
+    std::vector<uint32_t> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = static_cast<uint32_t>(i / 16 + (i % 1024 == 0 ? i * 2654435761U : 0));
+    }
+    const double megabytes = static_cast<double>(count * sizeof(uint32_t)) / (1024.0 * 1024.0);
+
+    for (const size_t threads : { size_t(1), size_t(0) }) {
+        const sbs::CompressionOptions options { .threads = threads };
+        std::vector<std::byte> bytes;
+        const double serialize_seconds = best_seconds(
+            iterations, [&] { bytes = sbs::serialize_compressed_to_vector(values, { }, options); });
+        std::vector<uint32_t> values_out;
+        const double deserialize_seconds = best_seconds(
+            iterations, [&] { sbs::deserialize_compressed_from_span(bytes, values_out, { }, options); });
+        if (values_out != values) {
+            std::cerr << "Round trip mismatch" << std::endl;
+        }
+        std::cout << (threads == 1 ? "1 thread   " : "all threads") << "  ratio: "
+                  << static_cast<double>(count * sizeof(uint32_t)) / static_cast<double>(bytes.size())
+                  << "  serialize: " << megabytes / serialize_seconds
+                  << " MB/s  deserialize: " << megabytes / deserialize_seconds << " MB/s\n";
+    }
+}
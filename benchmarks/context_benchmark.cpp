@@ -0,0 +1,81 @@
+#include <sbs/context.hpp>
+#include <sbs/sbs.hpp>
+
+#include <sbs/serializers/string.hpp>
+#include <sbs/serializers/vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+struct Request {
+    uint64_t id;
+    std::string method;
+    std::vector<uint32_t> arguments;
+
+    void serialize(sbs::Archive& ar)
+    {
+        ar.archive(id);
+        ar.archive(method);
+        ar.archive(arguments);
+    }
+};
+
+template <class Function>
+double best_seconds(const int iterations, Function&& function)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+int main()
+{
+    constexpr int iterations = 10;
+    constexpr int count = 1000000;
+    Request request { .id = 42, .method = "get_user_profile", .arguments = { 1, 2, 3, 4 } };
+    size_t total = 0;
+
+    const double vector_seconds = best_seconds(iterations, [&] {
+        for (int i = 0; i < count; ++i) {
+            request.id = static_cast<uint64_t>(i);
+            total += sbs::serialize_to_vector(request).size();
+        }
+    });
+    sbs::SerializeContext context;
+    const double context_seconds = best_seconds(iterations, [&] {
+        for (int i = 0; i < count; ++i) {
+            request.id = static_cast<uint64_t>(i);
+            context.reset();
+            total += context.serialize(request).size();
+        }
+    });
+    const double pooled_seconds = best_seconds(iterations, [&] {
+        for (int i = 0; i < count; ++i) {
+            request.id = static_cast<uint64_t>(i);
+            const sbs::PooledSerializeContext pooled = sbs::acquire_serialize_context();
+            total += pooled->serialize(request).size();
+        }
+    });
+    std::array<std::byte, 256> buffer;
+    const double span_seconds = best_seconds(iterations, [&] {
+        for (int i = 0; i < count; ++i) {
+            request.id = static_cast<uint64_t>(i);
+            total += sbs::serialize_into(buffer, request).value_or(0);
+        }
+    });
+    const auto rate = [](const double seconds) { return static_cast<double>(count) / seconds / 1e6; };
+    std::cout << "serialize_to_vector: " << rate(vector_seconds) << " M/s  context: " << rate(context_seconds)
+              << " M/s  pooled context: " << rate(pooled_seconds) << " M/s  span: " << rate(span_seconds) << " M/s\n";
+    return total == 0 ? 1 : 0;
+}
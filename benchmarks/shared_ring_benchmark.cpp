@@ -0,0 +1,130 @@
+#include <sbs/sbs.hpp>
+#include <sbs/shared_ring.hpp>
+
+#include <sbs/serializers/string.hpp>
+#include <sbs/serializers/vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+struct Request {
+    uint64_t id;
+    std::string method;
+    std::vector<uint32_t> arguments;
+
+    void serialize(sbs::Archive& ar)
+    {
+        ar.archive(id);
+        ar.archive(method);
+        ar.archive(arguments);
+    }
+};
+
+constexpr int warmup_count = 10000;
+constexpr int count = 100000;
+
+// Measures round trips of a request sent to a child process which sends it back, and reports one-way latencies as
+// half of each round trip.
+template <class Send, class Receive>
+void report(const char* name, std::vector<double>& latencies, Send&& send, Receive&& receive)
+{
+    Request request { .id = 0, .method = "get_user_profile", .arguments = { 1, 2, 3, 4 } };
+    for (int i = 0; i < warmup_count + count; ++i) {
+        request.id = static_cast<uint64_t>(i);
+        const auto start = std::chrono::steady_clock::now();
+        send(request);
+        receive(request);
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        if (i >= warmup_count) {
+            latencies.push_back(elapsed.count() / 2);
+        }
+    }
+    std::ranges::sort(latencies);
+    const auto percentile = [&](const double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+    std::cout << name << ": median " << percentile(0.5) << " us  p99 " << percentile(0.99) << " us  p99.9 "
+              << percentile(0.999) << " us\n";
+}
+
+void benchmark_shared_ring()
+{
+    const std::string name = "/sbs_benchmark_ring_" + std::to_string(::getpid());
+    sbs::SharedRing requests = sbs::SharedRing::create(name + "_requests", { .capacity = 64 * 1024 });
+    sbs::SharedRing responses = sbs::SharedRing::create(name + "_responses", { .capacity = 64 * 1024 });
+    sbs::SharedRing::remove(name + "_requests");
+    sbs::SharedRing::remove(name + "_responses");
+    const pid_t child = ::fork();
+    if (child == 0) {
+        sbs::SharedRingReader reader { requests };
+        sbs::SharedRingWriter writer { responses };
+        Request request { };
+        for (int i = 0; i < warmup_count + count; ++i) {
+            sbs::deserialize_using_reader<sbs::DefaultSerializer<Request>>(request, reader);
+            sbs::serialize_using_writer<sbs::DefaultSerializer<Request>>(request, writer);
+        }
+        ::_exit(0);
+    }
+    sbs::SharedRingWriter writer { requests };
+    sbs::SharedRingReader reader { responses };
+    std::vector<double> latencies;
+    report(
+        "shared ring",
+        latencies,
+        [&](Request& request) { sbs::serialize_using_writer<sbs::DefaultSerializer<Request>>(request, writer); },
+        [&](Request& request) { sbs::deserialize_using_reader<sbs::DefaultSerializer<Request>>(request, reader); });
+    ::waitpid(child, nullptr, 0);
+}
+
+void benchmark_socket()
+{
+    std::array<int, 2> sockets { };
+    if (::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets.data()) == -1) {
+        std::cerr << "Unable to create socket pair\n";
+        return;
+    }
+    const pid_t child = ::fork();
+    if (child == 0) {
+        ::close(sockets[0]);
+        std::array<std::byte, 4096> buffer;
+        for (int i = 0; i < warmup_count + count; ++i) {
+            const ssize_t size = ::recv(sockets[1], buffer.data(), buffer.size(), 0);
+            Request request { };
+            sbs::deserialize_from_span(std::span(buffer).first(static_cast<size_t>(size)), request);
+            const std::vector<std::byte> bytes = sbs::serialize_to_vector(request);
+            ::send(sockets[1], bytes.data(), bytes.size(), 0);
+        }
+        ::_exit(0);
+    }
+    ::close(sockets[1]);
+    std::array<std::byte, 4096> buffer;
+    std::vector<double> latencies;
+    report(
+        "socket",
+        latencies,
+        [&](Request& request) {
+            const std::vector<std::byte> bytes = sbs::serialize_to_vector(request);
+            ::send(sockets[0], bytes.data(), bytes.size(), 0);
+        },
+        [&](Request& request) {
+            const ssize_t size = ::recv(sockets[0], buffer.data(), buffer.size(), 0);
+            sbs::deserialize_from_span(std::span(buffer).first(static_cast<size_t>(size)), request);
+        });
+    ::waitpid(child, nullptr, 0);
+    ::close(sockets[0]);
+}
+
+int main()
+{
+    benchmark_shared_ring();
+    benchmark_socket();
+    return 0;
+}
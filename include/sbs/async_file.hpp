@@ -0,0 +1,196 @@
+#ifndef SBS_ASYNC_FILE_HPP
+#define SBS_ASYNC_FILE_HPP
+
+#include <sbs/sbs.hpp>
+#include <sbs/thread_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace sbs {
+
+struct AsyncFileWriterOptions {
+    // Size of each buffer handed to the background thread.
+    size_t buffer_size = 4 * 1024 * 1024;
+    // Number of buffers, which bounds the memory used to `buffer_count * buffer_size`. One buffer is filled while the
+    // others are written, so there are at least 2.
+    size_t buffer_count = 2;
+    // Whether `finish` waits for the data to reach the storage device, as with `FileWriter::sync`.
+    bool sync_on_finish = false;
+};
+
+// Writes to a file on a background thread so that serializing does not wait for the disk. The archive fills one
+// buffer while the background thread writes the others to the file. Once every buffer is in flight, handing over
+// another waits for the oldest to be written, so memory stays bounded when the disk is slower than serialization.
+//
+// A write error on the background thread stops all further writes. It is thrown from the next buffer handover or from
+// `finish`, which must be called once writing is done to observe errors.
+class AsyncFileWriter {
+public:
+    explicit AsyncFileWriter(const std::filesystem::path& path, const AsyncFileWriterOptions& options = { })
+        : m_file { path, FileWriterOptions { .buffer_size = 0 } }
+        , m_buffer_size { std::max<size_t>(options.buffer_size, 1) }
+        , m_buffer_count { std::max<size_t>(options.buffer_count, 2) }
+        , m_sync_on_finish { options.sync_on_finish }
+        , m_buffer { std::make_unique_for_overwrite<std::byte[]>(m_buffer_size) }
+    {
+    }
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    // Buffered bytes are written on destruction but errors can only be observed by calling `finish` beforehand. Any
+    // exception rethrown from the background thread is discarded here, whatever its type.
+    ~AsyncFileWriter()
+    {
+        if (!m_finished) {
+            try {
+                finish();
+            } catch (...) {
+            }
+        }
+    }
+
+    void write(std::span<const std::byte> bytes)
+    {
+        while (!bytes.empty()) {
+            if (m_size == m_buffer_size) {
+                hand_over();
+            }
+            const size_t size = std::min(bytes.size(), m_buffer_size - m_size);
+            std::memcpy(m_buffer.get() + m_size, bytes.data(), size);
+            m_size += size;
+            bytes = bytes.subspan(size);
+        }
+    }
+
+    std::span<std::byte> prepare(const size_t size)
+    {
+        if (m_buffer_size - m_size < size && m_size > 0) {
+            hand_over();
+        }
+        return { m_buffer.get() + m_size, m_buffer_size - m_size };
+    }
+
+    void commit(const size_t size)
+    {
+        m_size += size;
+    }
+
+    // Writes the buffered bytes and waits until everything has been written, then syncs the file if
+    // `AsyncFileWriterOptions::sync_on_finish` is set. Throws the first error from the background thread.
+    void finish()
+    {
+        m_finished = true;
+        if (m_size > 0) {
+            hand_over();
+        }
+        while (!m_in_flight.empty()) {
+            reclaim_oldest();
+        }
+        if (m_error != nullptr) {
+            std::rethrow_exception(m_error);
+        }
+        if (m_sync_on_finish) {
+            m_file.sync();
+        }
+    }
+
+private:
+    // Only accessed by the background thread until `finish` has waited for every write.
+    FileWriter m_file;
+    bool m_failed { };
+    size_t m_buffer_size;
+    size_t m_buffer_count;
+    bool m_sync_on_finish;
+    std::unique_ptr<std::byte[]> m_buffer;
+    size_t m_size { };
+    std::vector<std::unique_ptr<std::byte[]>> m_spare_buffers;
+    std::deque<std::future<std::unique_ptr<std::byte[]>>> m_in_flight;
+    std::exception_ptr m_error;
+    bool m_finished { };
+    // Declared last so that its thread is joined before anything it uses is destroyed.
+    detail::ThreadPool m_pool { 1 };
+
+    void hand_over()
+    {
+        if (m_error != nullptr) {
+            std::rethrow_exception(m_error);
+        }
+        m_in_flight.push_back(
+            m_pool.submit([this, buffer = std::move(m_buffer), size = std::exchange(m_size, 0)]() mutable {
+                if (!m_failed) {
+                    try {
+                        m_file.write({ buffer.get(), size });
+                    } catch (...) {
+                        m_failed = true;
+                        throw;
+                    }
+                }
+                return std::move(buffer);
+            }));
+        if (m_spare_buffers.empty() && m_in_flight.size() >= m_buffer_count) {
+            reclaim_oldest();
+        }
+        if (!m_spare_buffers.empty()) {
+            m_buffer = std::move(m_spare_buffers.back());
+            m_spare_buffers.pop_back();
+        } else {
+            m_buffer = std::make_unique_for_overwrite<std::byte[]>(m_buffer_size);
+        }
+        if (m_error != nullptr) {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+    void reclaim_oldest()
+    {
+        std::future<std::unique_ptr<std::byte[]>> future = std::move(m_in_flight.front());
+        m_in_flight.pop_front();
+        try {
+            m_spare_buffers.push_back(future.get());
+        } catch (...) {
+            if (m_error == nullptr) {
+                m_error = std::current_exception();
+            }
+        }
+    }
+};
+
+// Serializes to a file with `AsyncFileWriter`, returning once everything has been written.
+template <class TypeSerializer, class Type>
+    requires(Serializer<TypeSerializer, Type>)
+void serialize_to_file_async(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const AsyncFileWriterOptions& options = { })
+{
+    AsyncFileWriter writer { path, options };
+    serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+    writer.finish();
+}
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+void serialize_to_file_async(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const AsyncFileWriterOptions& options = { })
+{
+    serialize_to_file_async<DefaultSerializer<Type>>(path, value, archive_options, options);
+}
+
+}
+
+#endif // SBS_ASYNC_FILE_HPP
@@ -0,0 +1,353 @@
+#ifndef SBS_CHECKSUM_HPP
+#define SBS_CHECKSUM_HPP
+
+#include <sbs/sbs.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace sbs {
+
+namespace detail {
+
+// CRC-32C (Castagnoli) in its reflected form, as computed by the SSE4.2 and ARMv8 CRC instructions.
+constexpr uint32_t crc32c_polynomial = 0x82f63b78;
+
+consteval std::array<std::array<uint32_t, 256>, 8> make_crc32c_tables()
+{
+    std::array<std::array<uint32_t, 256>, 8> tables { };
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) != 0 ? crc32c_polynomial : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t table = 1; table < tables.size(); ++table) {
+            const uint32_t previous = tables[table - 1][i];
+            tables[table][i] = (previous >> 8) ^ tables[0][previous & 0xff];
+        }
+    }
+    return tables;
+}
+
+inline constexpr std::array<std::array<uint32_t, 256>, 8> crc32c_tables = make_crc32c_tables();
+
+// Slicing-by-8: each table lookup handles one of 8 bytes so a whole 8 byte word is folded in per iteration.
+inline uint32_t crc32c_software(uint32_t crc, std::span<const std::byte> bytes)
+{
+    const auto& t = crc32c_tables;
+    while (bytes.size() >= 8) {
+        uint32_t low;
+        uint32_t high;
+        std::memcpy(&low, bytes.data(), 4);
+        std::memcpy(&high, bytes.data() + 4, 4);
+        if constexpr (std::endian::native == std::endian::big) {
+            auto* low_bytes = reinterpret_cast<std::byte*>(&low);
+            auto* high_bytes = reinterpret_cast<std::byte*>(&high);
+            byteswap_copy<4>(low_bytes, low_bytes, 1);
+            byteswap_copy<4>(high_bytes, high_bytes, 1);
+        }
+        low ^= crc;
+        crc = t[7][low & 0xff] ^ t[6][(low >> 8) & 0xff] ^ t[5][(low >> 16) & 0xff] ^ t[4][low >> 24]
+            ^ t[3][high & 0xff] ^ t[2][(high >> 8) & 0xff] ^ t[1][(high >> 16) & 0xff] ^ t[0][high >> 24];
+        bytes = bytes.subspan(8);
+    }
+    for (const std::byte byte : bytes) {
+        crc = (crc >> 8) ^ t[0][(crc ^ std::to_integer<uint32_t>(byte)) & 0xff];
+    }
+    return crc;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(__GNUC__) || defined(__clang__)
+[[gnu::target("sse4.2")]]
+#endif
+inline uint32_t crc32c_hardware(uint32_t crc, std::span<const std::byte> bytes)
+{
+    uint64_t crc64 = crc;
+    while (bytes.size() >= 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes.data(), 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        bytes = bytes.subspan(8);
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (const std::byte byte : bytes) {
+        crc = _mm_crc32_u8(crc, std::to_integer<uint8_t>(byte));
+    }
+    return crc;
+}
+#elif defined(__ARM_FEATURE_CRC32)
+inline uint32_t crc32c_hardware(uint32_t crc, std::span<const std::byte> bytes)
+{
+    while (bytes.size() >= 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes.data(), 8);
+        crc = __crc32cd(crc, word);
+        bytes = bytes.subspan(8);
+    }
+    for (const std::byte byte : bytes) {
+        crc = __crc32cb(crc, std::to_integer<uint8_t>(byte));
+    }
+    return crc;
+}
+#endif
+
+// Updates a CRC-32C whose state is kept inverted, using the CRC instructions when the CPU has them.
+inline uint32_t crc32c_update(const uint32_t crc, const std::span<const std::byte> bytes)
+{
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__SSE4_2__) || defined(__AVX__))
+    return crc32c_hardware(crc, bytes);
+#elif defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    static const bool hardware = __builtin_cpu_supports("sse4.2");
+    return hardware ? crc32c_hardware(crc, bytes) : crc32c_software(crc, bytes);
+#elif defined(__ARM_FEATURE_CRC32)
+    return crc32c_hardware(crc, bytes);
+#else
+    return crc32c_software(crc, bytes);
+#endif
+}
+
+}
+
+// Incrementally computes the CRC-32C of all bytes passed to `update`.
+class Crc32c {
+public:
+    void update(const std::span<const std::byte> bytes)
+    {
+        m_state = detail::crc32c_update(m_state, bytes);
+    }
+
+    [[nodiscard]] uint32_t value() const
+    {
+        return ~m_state;
+    }
+
+private:
+    uint32_t m_state { 0xffffffff };
+};
+
+// Checksums are appended as 4 byte little endian integers regardless of the archive's endian.
+constexpr size_t checksum_size = 4;
+
+// Forwards everything written to it to another writer, which must outlive this writer, while computing the CRC-32C
+// of the bytes. The other writer's buffer is passed through when it has one so no bytes are copied.
+template <Writer WriterType>
+class ChecksumWriter {
+public:
+    explicit ChecksumWriter(WriterType& writer)
+        : m_writer { writer }
+    {
+    }
+
+    void write(const std::span<const std::byte> bytes)
+    {
+        m_crc.update(bytes);
+        m_writer.write(bytes);
+    }
+
+    std::span<std::byte> prepare(const size_t size)
+        requires(BufferedWriter<WriterType>)
+    {
+        m_prepared = m_writer.prepare(size);
+        return m_prepared;
+    }
+
+    void commit(const size_t size)
+        requires(BufferedWriter<WriterType>)
+    {
+        m_crc.update(m_prepared.first(size));
+        m_writer.commit(size);
+    }
+
+    [[nodiscard]] uint32_t checksum() const
+    {
+        return m_crc.value();
+    }
+
+    // Writes the checksum of everything written so far to the other writer.
+    void write_checksum()
+    {
+        const uint32_t checksum = m_crc.value();
+        std::array<std::byte, checksum_size> bytes;
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            bytes[i] = static_cast<std::byte>(checksum >> (8 * i));
+        }
+        m_writer.write(bytes);
+    }
+
+private:
+    WriterType& m_writer;
+    Crc32c m_crc;
+    std::span<std::byte> m_prepared;
+};
+
+// Forwards reads from another reader, which must outlive this reader, while computing the CRC-32C of the bytes
+// consumed. The other reader's buffer is passed through when it has one so no bytes are copied.
+template <Reader ReaderType>
+class ChecksumReader {
+public:
+    static constexpr bool contiguous = ContiguousReader<ReaderType>;
+
+    explicit ChecksumReader(ReaderType& reader)
+        : m_reader { reader }
+    {
+    }
+
+    std::span<const std::byte> read(const size_t size)
+    {
+        const std::span<const std::byte> bytes = m_reader.read(size);
+        m_crc.update(bytes);
+        return bytes;
+    }
+
+    std::span<const std::byte> data(const size_t size)
+        requires(BufferedReader<ReaderType>)
+    {
+        m_data = m_reader.data(size);
+        return m_data;
+    }
+
+    void consume(const size_t size)
+        requires(BufferedReader<ReaderType>)
+    {
+        m_crc.update(m_data.first(size));
+        m_data = m_data.subspan(size);
+        m_reader.consume(size);
+    }
+
+    [[nodiscard]] uint32_t checksum() const
+    {
+        return m_crc.value();
+    }
+
+    // Reads a checksum written by `ChecksumWriter::write_checksum` from the other reader and throws if it does not
+    // match the checksum of everything read so far.
+    void verify_checksum()
+    {
+        const std::span<const std::byte> bytes = m_reader.read(checksum_size);
+        if (bytes.size() < checksum_size) {
+            throw std::runtime_error("Insufficient data to deserialize");
+        }
+        uint32_t expected = 0;
+        for (size_t i = 0; i < checksum_size; ++i) {
+            expected |= std::to_integer<uint32_t>(bytes[i]) << (8 * i);
+        }
+        if (expected != m_crc.value()) {
+            throw std::runtime_error("Checksum mismatch");
+        }
+    }
+
+private:
+    ReaderType& m_reader;
+    Crc32c m_crc;
+    std::span<const std::byte> m_data;
+};
+
+template <class TypeSerializer, class Type>
+    requires(Serializer<TypeSerializer, Type>)
+std::vector<std::byte> serialize_checksummed_to_vector(Type& value, const ArchiveOptions& archive_options = { })
+{
+    std::vector<std::byte> result;
+    {
+        VectorWriter vector_writer { result };
+        ChecksumWriter writer { vector_writer };
+        serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+        writer.write_checksum();
+    }
+    return result;
+}
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+std::vector<std::byte> serialize_checksummed_to_vector(Type& value, const ArchiveOptions& archive_options = { })
+{
+    return serialize_checksummed_to_vector<DefaultSerializer<Type>>(value, archive_options);
+}
+
+template <class TypeSerializer, class Type>
+    requires(Serializer<TypeSerializer, Type>)
+void deserialize_checksummed_from_span(
+    const std::span<const std::byte> bytes, Type& value, const ArchiveOptions& archive_options = { })
+{
+    SpanReader span_reader { bytes };
+    ChecksumReader reader { span_reader };
+    deserialize_using_reader<TypeSerializer>(value, reader, archive_options);
+    reader.verify_checksum();
+}
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+void deserialize_checksummed_from_span(
+    const std::span<const std::byte> bytes, Type& value, const ArchiveOptions& archive_options = { })
+{
+    deserialize_checksummed_from_span<DefaultSerializer<Type>>(bytes, value, archive_options);
+}
+
+template <class TypeSerializer, class Type>
+    requires(Serializer<TypeSerializer, Type>)
+void serialize_checksummed_to_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const FileWriterOptions& options = { })
+{
+    FileWriter file_writer { path, options };
+    ChecksumWriter writer { file_writer };
+    serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+    writer.write_checksum();
+    file_writer.flush();
+}
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+void serialize_checksummed_to_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const FileWriterOptions& options = { })
+{
+    serialize_checksummed_to_file<DefaultSerializer<Type>>(path, value, archive_options, options);
+}
+
+template <class TypeSerializer, class Type>
+    requires(Serializer<TypeSerializer, Type>)
+void deserialize_checksummed_from_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const FileReaderOptions& options = { })
+{
+    FileReader file_reader { path, options };
+    ChecksumReader reader { file_reader };
+    deserialize_using_reader<TypeSerializer>(value, reader, archive_options);
+    reader.verify_checksum();
+}
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+void deserialize_checksummed_from_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const FileReaderOptions& options = { })
+{
+    deserialize_checksummed_from_file<DefaultSerializer<Type>>(path, value, archive_options, options);
+}
+
+}
+
+#endif // SBS_CHECKSUM_HPP
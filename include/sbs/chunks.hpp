@@ -0,0 +1,298 @@
+#ifndef SBS_CHUNKS_HPP
+#define SBS_CHUNKS_HPP
+
+#include <sbs/sbs.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sbs {
+
+namespace detail {
+
+// Thrown into the producer when the consumer stops pulling chunks early so that serialization unwinds.
+struct ChunksCancelled { };
+
+// Hands chunks from the serializing thread to the consumer one at a time. Only two chunk buffers exist: the one
+// being filled and the one held by the consumer, which swap when the consumer pulls the next chunk.
+class ChunkChannel {
+public:
+    explicit ChunkChannel(const size_t size)
+        : chunk_size { std::max<size_t>(size, 1) }
+    {
+    }
+
+    const size_t chunk_size;
+
+    // Called by the producer with a filled chunk, which is exchanged for the consumer's previous chunk once the
+    // consumer pulls it.
+    void publish(std::vector<std::byte>& chunk)
+    {
+        std::unique_lock lock { m_mutex };
+        m_ready = std::move(chunk);
+        m_has_ready = true;
+        m_condition.notify_all();
+        m_condition.wait(lock, [this] { return !m_has_ready || m_cancelled; });
+        if (m_cancelled) {
+            throw ChunksCancelled { };
+        }
+        chunk = std::move(m_ready);
+    }
+
+    void finish(std::exception_ptr error)
+    {
+        std::lock_guard lock { m_mutex };
+        m_finished = true;
+        m_error = std::move(error);
+        m_condition.notify_all();
+    }
+
+    // Called by the consumer with the chunk it is done with, returning the next chunk or false at the end.
+    bool next(std::vector<std::byte>& chunk)
+    {
+        std::unique_lock lock { m_mutex };
+        m_condition.wait(lock, [this] { return m_has_ready || m_finished; });
+        if (m_has_ready) {
+            std::swap(chunk, m_ready);
+            m_has_ready = false;
+            m_condition.notify_all();
+            return true;
+        }
+        if (m_error != nullptr) {
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+        }
+        return false;
+    }
+
+    void cancel()
+    {
+        std::lock_guard lock { m_mutex };
+        m_cancelled = true;
+        m_condition.notify_all();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    // Holds the published chunk until the consumer takes it, then the consumer's previous chunk until the producer
+    // takes it back.
+    std::vector<std::byte> m_ready;
+    bool m_has_ready { };
+    bool m_finished { };
+    bool m_cancelled { };
+    std::exception_ptr m_error;
+};
+
+class ChunkWriter {
+public:
+    explicit ChunkWriter(ChunkChannel& channel)
+        : m_channel { channel }
+    {
+        m_chunk.reserve(channel.chunk_size);
+    }
+
+    void write(std::span<const std::byte> bytes)
+    {
+        while (!bytes.empty()) {
+            const std::span<std::byte> buffer = prepare(bytes.size());
+            const size_t size = std::min(buffer.size(), bytes.size());
+            std::memcpy(buffer.data(), bytes.data(), size);
+            commit(size);
+            bytes = bytes.subspan(size);
+        }
+    }
+
+    // Hands out the rest of the current chunk, which may be smaller than `size`.
+    std::span<std::byte> prepare(const size_t)
+    {
+        if (m_size == m_channel.chunk_size) {
+            publish();
+        }
+        m_chunk.resize(m_channel.chunk_size);
+        return std::span(m_chunk).subspan(m_size);
+    }
+
+    void commit(const size_t size)
+    {
+        m_size += size;
+    }
+
+    void flush()
+    {
+        if (m_size > 0) {
+            publish();
+        }
+    }
+
+private:
+    ChunkChannel& m_channel;
+    std::vector<std::byte> m_chunk;
+    size_t m_size { };
+
+    void publish()
+    {
+        m_chunk.resize(std::exchange(m_size, 0));
+        m_channel.publish(m_chunk);
+    }
+};
+
+}
+
+// Serialized output pulled in chunks. See `serialize_chunks`.
+class ChunkGenerator {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::span<const std::byte>;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        explicit Iterator(ChunkGenerator& generator)
+            : m_generator { &generator }
+            , m_chunk { generator.next() }
+        {
+        }
+
+        const std::span<const std::byte>& operator*() const
+        {
+            return m_chunk;
+        }
+
+        Iterator& operator++()
+        {
+            m_chunk = m_generator->next();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const
+        {
+            return m_chunk.empty();
+        }
+
+    private:
+        ChunkGenerator* m_generator { };
+        std::span<const std::byte> m_chunk;
+    };
+
+    template <class TypeSerializer, class Type>
+        requires(Serializer<TypeSerializer, Type>)
+    static ChunkGenerator create(Type& value, const size_t chunk_size, const ArchiveOptions& archive_options)
+    {
+        ChunkGenerator generator { chunk_size };
+        detail::ChunkChannel* channel = generator.m_channel.get();
+        generator.m_thread = std::thread([channel, &value, archive_options] {
+            std::exception_ptr error;
+            try {
+                detail::ChunkWriter writer { *channel };
+                serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+                writer.flush();
+            } catch (const detail::ChunksCancelled&) {
+            } catch (...) {
+                error = std::current_exception();
+            }
+            channel->finish(std::move(error));
+        });
+        return generator;
+    }
+
+    ChunkGenerator(const ChunkGenerator&) = delete;
+    ChunkGenerator& operator=(const ChunkGenerator&) = delete;
+    ChunkGenerator(ChunkGenerator&&) noexcept = default;
+
+    ChunkGenerator& operator=(ChunkGenerator&& other) noexcept
+    {
+        if (this != &other) {
+            stop();
+            m_channel = std::move(other.m_channel);
+            m_chunk = std::move(other.m_chunk);
+            m_thread = std::move(other.m_thread);
+        }
+        return *this;
+    }
+
+    // Stopping early cancels serialization, which unwinds out of the serializer with an internal exception.
+    ~ChunkGenerator()
+    {
+        stop();
+    }
+
+    // Returns the next chunk, which stays valid until the next call, or an empty span once all bytes have been
+    // returned. Exceptions thrown by serialization are rethrown here.
+    std::span<const std::byte> next()
+    {
+        if (m_channel == nullptr || !m_channel->next(m_chunk)) {
+            return { };
+        }
+        return m_chunk;
+    }
+
+    Iterator begin()
+    {
+        return Iterator { *this };
+    }
+
+    std::default_sentinel_t end() const
+    {
+        return { };
+    }
+
+private:
+    std::unique_ptr<detail::ChunkChannel> m_channel;
+    std::vector<std::byte> m_chunk;
+    std::thread m_thread;
+
+    explicit ChunkGenerator(const size_t chunk_size)
+        : m_channel { std::make_unique<detail::ChunkChannel>(chunk_size) }
+    {
+    }
+
+    void stop()
+    {
+        if (m_thread.joinable()) {
+            m_channel->cancel();
+            m_thread.join();
+        }
+    }
+};
+
+// Serializes `value` on demand, yielding chunks of `chunk_size` bytes (the last one may be shorter) as they are
+// pulled. Serialization runs ahead by one chunk and is paused until that chunk is pulled, so at most two chunks are in
+// memory at once regardless of the size of the value. `value` must outlive the generator.
+//
+// Serializers cannot be suspended as coroutines, so each generator starts a thread that serializes for its lifetime.
+// Creating a generator costs a thread creation and each chunk a handoff between threads, so it suits large values
+// rather than many small messages.
+template <class TypeSerializer, class Type>
+    requires(Serializer<TypeSerializer, Type>)
+ChunkGenerator serialize_chunks(Type& value, const size_t chunk_size, const ArchiveOptions& archive_options = { })
+{
+    return ChunkGenerator::create<TypeSerializer>(value, chunk_size, archive_options);
+}
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+ChunkGenerator serialize_chunks(Type& value, const size_t chunk_size, const ArchiveOptions& archive_options = { })
+{
+    return serialize_chunks<DefaultSerializer<Type>>(value, chunk_size, archive_options);
+}
+
+}
+
+#endif // SBS_CHUNKS_HPP
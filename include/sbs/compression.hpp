@@ -0,0 +1,650 @@
+#ifndef SBS_COMPRESSION_HPP
+#define SBS_COMPRESSION_HPP
+
+#include <sbs/sbs.hpp>
+#include <sbs/thread_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace sbs {
+
+// Compresses and decompresses independent blocks. `compress` and `decompress` may be called concurrently from
+// multiple threads on the same codec.
+template <class Type>
+concept Codec = requires(const Type& codec, std::span<const std::byte> input, std::span<std::byte> output) {
+    // Upper bound of the compressed size of an input of the given size.
+    { codec.max_compressed_size(input.size()) } -> std::same_as<size_t>;
+    // Compresses `input` into `output`, which is at least `max_compressed_size(input.size())` bytes, and returns the
+    // compressed size.
+    { codec.compress(input, output) } -> std::same_as<size_t>;
+    // Decompresses `input` into `output`, which is exactly the uncompressed size, and throws on corrupt input.
+    { codec.decompress(input, output) } -> std::same_as<void>;
+};
+
+// A byte-oriented LZ77 codec in the style of LZ4 which favors speed over ratio. Each sequence is a token holding the
+// literal length and match length in its high and low nibbles, length extensions of 255-valued bytes for nibbles
+// of 15, the literals, then a 2 byte little endian match offset. The last sequence has literals only.
+class LzCodec {
+public:
+    [[nodiscard]] size_t max_compressed_size(const size_t size) const
+    {
+        return size + size / 255 + 16;
+    }
+
+    size_t compress(const std::span<const std::byte> input, const std::span<std::byte> output) const
+    {
+        std::array<uint32_t, hash_table_size> table;
+        table.fill(no_position);
+        const std::byte* const begin = input.data();
+        const std::byte* const end = begin + input.size();
+        std::byte* out = output.data();
+        const std::byte* anchor = begin;
+        const std::byte* position = begin;
+        while (end - position >= static_cast<std::ptrdiff_t>(min_match)) {
+            const uint32_t sequence = load_32(position);
+            uint32_t& entry = table[hash(sequence)];
+            const std::byte* candidate = entry == no_position ? nullptr : begin + entry;
+            entry = static_cast<uint32_t>(position - begin);
+            if (candidate == nullptr || position - candidate > max_offset || load_32(candidate) != sequence) {
+                // Step faster through input that does not match so that incompressible data is skipped quickly, but
+                // never past the end of the input.
+                position += std::min<std::ptrdiff_t>(1 + ((position - anchor) >> 6), end - position);
+                continue;
+            }
+            const std::byte* match_end = position + min_match;
+            const std::byte* candidate_end = candidate + min_match;
+            while (match_end < end && *match_end == *candidate_end) {
+                ++match_end;
+                ++candidate_end;
+            }
+            out = write_sequence(
+                out,
+                { anchor, position },
+                static_cast<size_t>(match_end - position),
+                static_cast<uint16_t>(position - candidate));
+            position = anchor = match_end;
+        }
+        out = write_sequence(out, { anchor, end }, 0, 0);
+        return static_cast<size_t>(out - output.data());
+    }
+
+    void decompress(const std::span<const std::byte> input, const std::span<std::byte> output) const
+    {
+        const std::byte* in = input.data();
+        const std::byte* const in_end = in + input.size();
+        std::byte* out = output.data();
+        std::byte* const out_end = out + output.size();
+        while (true) {
+            if (in == in_end) {
+                throw std::runtime_error("Corrupt compressed data");
+            }
+            const auto token = std::to_integer<uint8_t>(*in++);
+            const size_t literal_size = read_length(in, in_end, token >> 4);
+            if (static_cast<size_t>(in_end - in) < literal_size
+                || static_cast<size_t>(out_end - out) < literal_size) {
+                throw std::runtime_error("Corrupt compressed data");
+            }
+            if (literal_size > 0) {
+                std::memcpy(out, in, literal_size);
+                in += literal_size;
+                out += literal_size;
+            }
+            if (in == in_end) {
+                break;
+            }
+            if (in_end - in < 2) {
+                throw std::runtime_error("Corrupt compressed data");
+            }
+            const size_t offset = std::to_integer<size_t>(in[0]) | std::to_integer<size_t>(in[1]) << 8;
+            in += 2;
+            const size_t match_size = read_length(in, in_end, token & 0xf) + min_match;
+            if (offset == 0 || offset > static_cast<size_t>(out - output.data())
+                || static_cast<size_t>(out_end - out) < match_size) {
+                throw std::runtime_error("Corrupt compressed data");
+            }
+            const std::byte* match = out - offset;
+            if (offset >= match_size) {
+                std::memcpy(out, match, match_size);
+                out += match_size;
+            } else {
+                // Overlapping matches repeat the last `offset` bytes so they must be copied front to back.
+                for (size_t i = 0; i < match_size; ++i) {
+                    *out++ = *match++;
+                }
+            }
+        }
+        if (out != out_end) {
+            throw std::runtime_error("Corrupt compressed data");
+        }
+    }
+
+private:
+    static constexpr size_t min_match = 4;
+    static constexpr std::ptrdiff_t max_offset = 65535;
+    static constexpr int hash_bits = 14;
+    static constexpr size_t hash_table_size = size_t(1) << hash_bits;
+    static constexpr uint32_t no_position = 0xffffffff;
+
+    static uint32_t load_32(const std::byte* bytes)
+    {
+        uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    static size_t hash(const uint32_t sequence)
+    {
+        return (sequence * 2654435761U) >> (32 - hash_bits);
+    }
+
+    static std::byte* write_length(std::byte* out, size_t length)
+    {
+        while (length >= 255) {
+            *out++ = std::byte { 255 };
+            length -= 255;
+        }
+        *out++ = static_cast<std::byte>(length);
+        return out;
+    }
+
+    static std::byte* write_sequence(
+        std::byte* out, const std::span<const std::byte> literals, const size_t match_size, const uint16_t offset)
+    {
+        const size_t match_length = match_size == 0 ? 0 : match_size - min_match;
+        std::byte& token = *out++;
+        token = static_cast<std::byte>(std::min<size_t>(literals.size(), 15) << 4 | std::min<size_t>(match_length, 15));
+        if (literals.size() >= 15) {
+            out = write_length(out, literals.size() - 15);
+        }
+        if (!literals.empty()) {
+            std::memcpy(out, literals.data(), literals.size());
+            out += literals.size();
+        }
+        if (match_size != 0) {
+            *out++ = static_cast<std::byte>(offset & 0xff);
+            *out++ = static_cast<std::byte>(offset >> 8);
+            if (match_length >= 15) {
+                out = write_length(out, match_length - 15);
+            }
+        }
+        return out;
+    }
+
+    static size_t read_length(const std::byte*& in, const std::byte* const in_end, const size_t nibble)
+    {
+        size_t length = nibble;
+        if (nibble == 15) {
+            uint8_t byte;
+            do {
+                if (in == in_end) {
+                    throw std::runtime_error("Corrupt compressed data");
+                }
+                byte = std::to_integer<uint8_t>(*in++);
+                length += byte;
+            } while (byte == 255);
+        }
+        return length;
+    }
+};
+
+struct CompressionOptions {
+    // Size of the uncompressed blocks that are compressed independently. Deserialization rejects blocks larger than
+    // this so it should match between serialization and deserialization.
+    size_t block_size = 1024 * 1024;
+    // Number of threads that compress or decompress blocks, where 0 uses one per hardware thread. With 1 thread
+    // blocks are processed inline on the calling thread.
+    size_t threads = 0;
+};
+
+namespace detail {
+
+// Blocks are framed by a little endian 4 byte uncompressed size and 4 byte stored size. Blocks that do not compress
+// are stored as is, which is signaled by equal sizes. The stream ends with an uncompressed size of 0.
+constexpr size_t block_header_size = 8;
+
+inline void write_block_header(std::byte* header, const uint32_t raw_size, const uint32_t stored_size)
+{
+    for (size_t i = 0; i < 4; ++i) {
+        header[i] = static_cast<std::byte>(raw_size >> (8 * i));
+        header[4 + i] = static_cast<std::byte>(stored_size >> (8 * i));
+    }
+}
+
+inline uint32_t read_block_header_field(const std::byte* field)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        value |= std::to_integer<uint32_t>(field[i]) << (8 * i);
+    }
+    return value;
+}
+
+}
+
+// Compresses everything written to it in blocks and writes the compressed blocks to another writer, which must
+// outlive this writer. `finish` must be called once writing is done to write the last block and the end of the
+// stream. Blocks are compressed on a shared pool of threads when `CompressionOptions::threads` is not 1, except for a
+// stream that fits in one block.
+template <Writer WriterType, Codec CodecType = LzCodec>
+class CompressedWriter {
+public:
+    explicit CompressedWriter(WriterType& writer, const CompressionOptions& options = { }, CodecType codec = { })
+        : m_writer { writer }
+        , m_codec { std::move(codec) }
+        , m_block_size { std::clamp<size_t>(options.block_size, 1, max_block_size) }
+        , m_block(m_block_size)
+    {
+        const size_t threads = detail::resolve_thread_count(options.threads);
+        // Waiting for the pool from one of its workers could deadlock, so nested streams compress inline.
+        if (threads > 1 && !detail::ThreadPool::on_worker_thread()) {
+            m_max_pending = threads * 2;
+            m_pool = &detail::shared_thread_pool(threads);
+        }
+    }
+
+    CompressedWriter(const CompressedWriter&) = delete;
+    CompressedWriter& operator=(const CompressedWriter&) = delete;
+
+    // The stream is finished on destruction but errors can only be observed by calling `finish` beforehand.
+    ~CompressedWriter()
+    {
+        try {
+            finish();
+        } catch (...) {
+        }
+        // Blocks still being compressed after a failed write reference this writer.
+        for (std::future<EncodedBlock>& future : m_pending) {
+            future.wait();
+        }
+    }
+
+    void write(std::span<const std::byte> bytes)
+    {
+        while (!bytes.empty()) {
+            const std::span<std::byte> buffer = prepare(bytes.size());
+            const size_t size = std::min(buffer.size(), bytes.size());
+            std::memcpy(buffer.data(), bytes.data(), size);
+            commit(size);
+            bytes = bytes.subspan(size);
+        }
+    }
+
+    // Hands out the rest of the current block, which may be smaller than `size`.
+    std::span<std::byte> prepare(const size_t)
+    {
+        if (m_size == m_block_size) {
+            submit_block();
+        }
+        return std::span(m_block).subspan(m_size);
+    }
+
+    void commit(const size_t size)
+    {
+        m_size += size;
+    }
+
+    // Compresses and writes all remaining bytes and the end of the stream. Nothing may be written afterwards.
+    void finish()
+    {
+        if (m_finished) {
+            return;
+        }
+        m_finished = true;
+        if (m_size > 0) {
+            submit_block();
+        }
+        while (!m_pending.empty()) {
+            write_pending();
+        }
+        std::array<std::byte, detail::block_header_size> end;
+        detail::write_block_header(end.data(), 0, 0);
+        m_writer.write(end);
+    }
+
+private:
+    static constexpr size_t max_block_size = 0x7fffffff;
+
+    struct EncodedBlock {
+        std::vector<std::byte> frame;
+        std::vector<std::byte> raw;
+    };
+
+    WriterType& m_writer;
+    CodecType m_codec;
+    size_t m_block_size;
+    std::vector<std::byte> m_block;
+    size_t m_size { };
+    bool m_finished { };
+    std::vector<std::vector<std::byte>> m_spare_blocks;
+    std::deque<std::future<EncodedBlock>> m_pending;
+    size_t m_max_pending { };
+    detail::ThreadPool* m_pool { };
+
+    void submit_block()
+    {
+        std::vector<std::byte> raw = std::exchange(m_block, take_spare_block());
+        const size_t size = std::exchange(m_size, 0);
+        // The last block is compressed inline when nothing else is in flight, so that a stream of a single block
+        // never waits for the pool.
+        if (m_pool == nullptr || (m_finished && m_pending.empty())) {
+            write_encoded(encode(std::move(raw), size));
+            return;
+        }
+        m_pending.push_back(m_pool->submit([this, raw = std::move(raw), size]() mutable {
+            return encode(std::move(raw), size);
+        }));
+        while (m_pending.size() > m_max_pending || (!m_pending.empty() && is_ready(m_pending.front()))) {
+            write_pending();
+        }
+    }
+
+    std::vector<std::byte> take_spare_block()
+    {
+        if (m_spare_blocks.empty()) {
+            return std::vector<std::byte>(m_block_size);
+        }
+        std::vector<std::byte> block = std::move(m_spare_blocks.back());
+        m_spare_blocks.pop_back();
+        return block;
+    }
+
+    EncodedBlock encode(std::vector<std::byte> raw, const size_t size) const
+    {
+        const std::span<const std::byte> input = std::span(raw).first(size);
+        std::vector<std::byte> frame(detail::block_header_size + m_codec.max_compressed_size(size));
+        size_t stored_size = m_codec.compress(input, std::span(frame).subspan(detail::block_header_size));
+        if (stored_size >= size) {
+            stored_size = size;
+            std::memcpy(frame.data() + detail::block_header_size, input.data(), size);
+        }
+        detail::write_block_header(frame.data(), static_cast<uint32_t>(size), static_cast<uint32_t>(stored_size));
+        frame.resize(detail::block_header_size + stored_size);
+        return { std::move(frame), std::move(raw) };
+    }
+
+    void write_encoded(EncodedBlock block)
+    {
+        m_writer.write(block.frame);
+        m_spare_blocks.push_back(std::move(block.raw));
+    }
+
+    void write_pending()
+    {
+        std::future<EncodedBlock> future = std::move(m_pending.front());
+        m_pending.pop_front();
+        write_encoded(future.get());
+    }
+
+    static bool is_ready(const std::future<EncodedBlock>& future)
+    {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+};
+
+// Decompresses a stream written by `CompressedWriter` from another reader, which must outlive this reader. Blocks
+// are read ahead and decompressed on a shared pool of threads when `CompressionOptions::threads` is not 1. Reading
+// stops at the end of the stream.
+template <Reader ReaderType, Codec CodecType = LzCodec>
+class CompressedReader {
+public:
+    explicit CompressedReader(ReaderType& reader, const CompressionOptions& options = { }, CodecType codec = { })
+        : m_reader { reader }
+        , m_codec { std::move(codec) }
+        , m_block_size { options.block_size }
+    {
+        const size_t threads = detail::resolve_thread_count(options.threads);
+        // Waiting for the pool from one of its workers could deadlock, so nested streams decompress inline.
+        if (threads > 1 && !detail::ThreadPool::on_worker_thread()) {
+            m_max_pending = threads * 2;
+            m_pool = &detail::shared_thread_pool(threads);
+        }
+    }
+
+    CompressedReader(const CompressedReader&) = delete;
+    CompressedReader& operator=(const CompressedReader&) = delete;
+
+    // Blocks read ahead but never consumed are still being decompressed with references to this reader.
+    ~CompressedReader()
+    {
+        for (std::future<std::vector<std::byte>>& future : m_pending) {
+            future.wait();
+        }
+    }
+
+    std::span<const std::byte> read(const size_t size)
+    {
+        const std::span<const std::byte> bytes = data(size);
+        const size_t available = std::min(size, bytes.size());
+        consume(available);
+        return bytes.first(available);
+    }
+
+    std::span<const std::byte> data(const size_t size)
+    {
+        while (m_block.size() - m_position < size && fetch_block()) { }
+        return std::span<const std::byte>(m_block).subspan(m_position);
+    }
+
+    void consume(const size_t size)
+    {
+        m_position += size;
+    }
+
+private:
+    struct StoredBlock {
+        std::vector<std::byte> bytes;
+        uint32_t raw_size;
+    };
+
+    ReaderType& m_reader;
+    CodecType m_codec;
+    size_t m_block_size;
+    std::vector<std::byte> m_block;
+    size_t m_position { };
+    bool m_source_finished { };
+    std::deque<std::future<std::vector<std::byte>>> m_pending;
+    size_t m_max_pending { };
+    detail::ThreadPool* m_pool { };
+
+    bool fetch_block()
+    {
+        std::vector<std::byte> block;
+        if (m_pool == nullptr) {
+            std::optional<StoredBlock> stored = read_block();
+            if (!stored.has_value()) {
+                return false;
+            }
+            block = decode(std::move(*stored));
+        } else {
+            while (m_pending.size() < m_max_pending) {
+                std::optional<StoredBlock> stored = read_block();
+                if (!stored.has_value()) {
+                    break;
+                }
+                m_pending.push_back(m_pool->submit([this, stored = std::move(*stored)]() mutable {
+                    return decode(std::move(stored));
+                }));
+            }
+            if (m_pending.empty()) {
+                return false;
+            }
+            block = m_pending.front().get();
+            m_pending.pop_front();
+        }
+        if (m_position == m_block.size()) {
+            m_block = std::move(block);
+        } else {
+            // Values that straddle blocks need the unconsumed tail and the next block to be contiguous.
+            m_block.erase(m_block.begin(), m_block.begin() + static_cast<std::ptrdiff_t>(m_position));
+            m_block.insert(m_block.end(), block.begin(), block.end());
+        }
+        m_position = 0;
+        return true;
+    }
+
+    std::optional<StoredBlock> read_block()
+    {
+        if (m_source_finished) {
+            return std::nullopt;
+        }
+        const std::span<const std::byte> header = read_exactly(detail::block_header_size);
+        const uint32_t raw_size = detail::read_block_header_field(header.data());
+        const uint32_t stored_size = detail::read_block_header_field(header.data() + 4);
+        if (raw_size == 0) {
+            m_source_finished = true;
+            return std::nullopt;
+        }
+        if (raw_size > m_block_size || stored_size > m_codec.max_compressed_size(raw_size)) {
+            throw std::runtime_error("Corrupt compressed data");
+        }
+        const std::span<const std::byte> bytes = read_exactly(stored_size);
+        return StoredBlock { { bytes.begin(), bytes.end() }, raw_size };
+    }
+
+    std::span<const std::byte> read_exactly(const size_t size)
+    {
+        const std::span<const std::byte> bytes = m_reader.read(size);
+        if (bytes.size() < size) {
+            throw std::runtime_error("Insufficient data to deserialize");
+        }
+        return bytes.first(size);
+    }
+
+    std::vector<std::byte> decode(StoredBlock stored) const
+    {
+        if (stored.bytes.size() == stored.raw_size) {
+            return std::move(stored.bytes);
+        }
+        std::vector<std::byte> block(stored.raw_size);
+        m_codec.decompress(stored.bytes, block);
+        return block;
+    }
+};
+
+template <class TypeSerializer, class Type, Codec CodecType = LzCodec>
+    requires(Serializer<TypeSerializer, Type>)
+std::vector<std::byte> serialize_compressed_to_vector(
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const CompressionOptions& options = { },
+    CodecType codec = { })
+{
+    std::vector<std::byte> result;
+    {
+        VectorWriter vector_writer { result };
+        CompressedWriter writer { vector_writer, options, std::move(codec) };
+        serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+        writer.finish();
+    }
+    return result;
+}
+
+template <class Type, Codec CodecType = LzCodec>
+    requires(DefaultSerializable<Type>)
+std::vector<std::byte> serialize_compressed_to_vector(
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const CompressionOptions& options = { },
+    CodecType codec = { })
+{
+    return serialize_compressed_to_vector<DefaultSerializer<Type>>(value, archive_options, options, std::move(codec));
+}
+
+template <class TypeSerializer, class Type, Codec CodecType = LzCodec>
+    requires(Serializer<TypeSerializer, Type>)
+void deserialize_compressed_from_span(
+    const std::span<const std::byte> bytes,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const CompressionOptions& options = { },
+    CodecType codec = { })
+{
+    SpanReader span_reader { bytes };
+    CompressedReader reader { span_reader, options, std::move(codec) };
+    deserialize_using_reader<TypeSerializer>(value, reader, archive_options);
+}
+
+template <class Type, Codec CodecType = LzCodec>
+    requires(DefaultSerializable<Type>)
+void deserialize_compressed_from_span(
+    const std::span<const std::byte> bytes,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const CompressionOptions& options = { },
+    CodecType codec = { })
+{
+    deserialize_compressed_from_span<DefaultSerializer<Type>>(bytes, value, archive_options, options, std::move(codec));
+}
+
+template <class TypeSerializer, class Type, Codec CodecType = LzCodec>
+    requires(Serializer<TypeSerializer, Type>)
+void serialize_compressed_to_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const CompressionOptions& options = { },
+    CodecType codec = { })
+{
+    FileWriter file_writer { path };
+    {
+        CompressedWriter writer { file_writer, options, std::move(codec) };
+        serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+        writer.finish();
+    }
+    file_writer.flush();
+}
+
+template <class Type, Codec CodecType = LzCodec>
+    requires(DefaultSerializable<Type>)
+void serialize_compressed_to_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const CompressionOptions& options = { },
+    CodecType codec = { })
+{
+    serialize_compressed_to_file<DefaultSerializer<Type>>(path, value, archive_options, options, std::move(codec));
+}
+
+template <class TypeSerializer, class Type, Codec CodecType = LzCodec>
+    requires(Serializer<TypeSerializer, Type>)
+void deserialize_compressed_from_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const CompressionOptions& options = { },
+    CodecType codec = { })
+{
+    FileReader file_reader { path };
+    CompressedReader reader { file_reader, options, std::move(codec) };
+    deserialize_using_reader<TypeSerializer>(value, reader, archive_options);
+}
+
+template <class Type, Codec CodecType = LzCodec>
+    requires(DefaultSerializable<Type>)
+void deserialize_compressed_from_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const CompressionOptions& options = { },
+    CodecType codec = { })
+{
+    deserialize_compressed_from_file<DefaultSerializer<Type>>(path, value, archive_options, options, std::move(codec));
+}
+
+}
+
+#endif // SBS_COMPRESSION_HPP
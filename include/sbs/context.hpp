@@ -0,0 +1,216 @@
+#ifndef SBS_CONTEXT_HPP
+#define SBS_CONTEXT_HPP
+
+#include <sbs/sbs.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace sbs {
+
+// Serializes values into a buffer that it owns and keeps across calls, so that once the buffer has grown to fit the
+// largest value, serializing does not allocate. Unlike `VectorWriter`, unused capacity is never zero-filled.
+class SerializeContext {
+public:
+    SerializeContext() = default;
+
+    SerializeContext(const SerializeContext&) = delete;
+    SerializeContext& operator=(const SerializeContext&) = delete;
+    SerializeContext(SerializeContext&&) noexcept = default;
+    SerializeContext& operator=(SerializeContext&&) noexcept = default;
+
+    // Appends the bytes of `value` after any bytes serialized since the last `reset` and returns them. The returned
+    // span, like `bytes`, is valid until the next call to a non-const method. If serialization throws, the partially
+    // serialized bytes are discarded.
+    template <class TypeSerializer, class Type>
+        requires(Serializer<TypeSerializer, Type>)
+    std::span<const std::byte> serialize(Type& value, const ArchiveOptions& archive_options = { })
+    {
+        const size_t begin = m_size;
+        try {
+            ContextWriter writer { *this };
+            serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+        } catch (...) {
+            m_size = begin;
+            throw;
+        }
+        return bytes().subspan(begin);
+    }
+
+    template <class Type>
+        requires(DefaultSerializable<Type>)
+    std::span<const std::byte> serialize(Type& value, const ArchiveOptions& archive_options = { })
+    {
+        return serialize<DefaultSerializer<Type>>(value, archive_options);
+    }
+
+    // All bytes serialized since the last `reset`.
+    [[nodiscard]] std::span<const std::byte> bytes() const
+    {
+        return { m_buffer.get(), m_size };
+    }
+
+    // Discards the serialized bytes while keeping the buffer's capacity.
+    void reset()
+    {
+        m_size = 0;
+    }
+
+    [[nodiscard]] size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+    // Shrinks the buffer to the serialized bytes, freeing it when there are none.
+    void shrink_to_fit()
+    {
+        if (m_size < m_capacity) {
+            reallocate(m_size);
+        }
+    }
+
+private:
+    class ContextWriter {
+    public:
+        explicit ContextWriter(SerializeContext& context)
+            : m_context { context }
+        {
+        }
+
+        void write(const std::span<const std::byte> bytes)
+        {
+            const std::span<std::byte> buffer = prepare(bytes.size());
+            std::memcpy(buffer.data(), bytes.data(), bytes.size());
+            commit(bytes.size());
+        }
+
+        std::span<std::byte> prepare(const size_t size)
+        {
+            if (m_context.m_capacity - m_context.m_size < size) {
+                m_context.reallocate(
+                    std::max({ m_context.m_size + size, m_context.m_capacity * 2, SerializeContext::min_capacity }));
+            }
+            return { m_context.m_buffer.get() + m_context.m_size, m_context.m_capacity - m_context.m_size };
+        }
+
+        void commit(const size_t size)
+        {
+            m_context.m_size += size;
+        }
+
+        [[nodiscard]] uint64_t position() const
+        {
+            return m_context.m_size;
+        }
+
+        void patch(const uint64_t position, const std::span<const std::byte> bytes)
+        {
+            std::memcpy(m_context.m_buffer.get() + position, bytes.data(), bytes.size());
+        }
+
+    private:
+        SerializeContext& m_context;
+    };
+
+    static constexpr size_t min_capacity = 256;
+
+    std::unique_ptr<std::byte[]> m_buffer;
+    size_t m_capacity { };
+    size_t m_size { };
+
+    // Callers never shrink below `m_size`, so a capacity of zero releases an empty buffer.
+    void reallocate(const size_t capacity)
+    {
+        if (capacity == 0) {
+            m_buffer.reset();
+            m_capacity = 0;
+            return;
+        }
+        std::unique_ptr<std::byte[]> buffer = std::make_unique_for_overwrite<std::byte[]>(capacity);
+        if (m_size > 0) {
+            std::memcpy(buffer.get(), m_buffer.get(), m_size);
+        }
+        m_buffer = std::move(buffer);
+        m_capacity = capacity;
+    }
+};
+
+namespace detail {
+
+// Contexts whose buffers have grown beyond this are shrunk when returned to a pool so that a single large value does
+// not keep its buffer alive for the rest of the thread.
+constexpr size_t max_pooled_capacity = 1024 * 1024;
+
+inline std::vector<std::unique_ptr<SerializeContext>>& serialize_context_pool()
+{
+    thread_local std::vector<std::unique_ptr<SerializeContext>> pool;
+    return pool;
+}
+
+}
+
+// A `SerializeContext` leased from the pool of the thread that acquired it, which it is returned to on destruction.
+// See `acquire_serialize_context`. The lease must be destroyed on the thread that acquired it.
+class PooledSerializeContext {
+public:
+    PooledSerializeContext()
+    {
+        std::vector<std::unique_ptr<SerializeContext>>& pool = detail::serialize_context_pool();
+        if (pool.empty()) {
+            m_context = std::make_unique<SerializeContext>();
+        } else {
+            m_context = std::move(pool.back());
+            pool.pop_back();
+        }
+    }
+
+    PooledSerializeContext(const PooledSerializeContext&) = delete;
+    PooledSerializeContext& operator=(const PooledSerializeContext&) = delete;
+    PooledSerializeContext(PooledSerializeContext&&) noexcept = default;
+    PooledSerializeContext& operator=(PooledSerializeContext&&) noexcept = delete;
+
+    ~PooledSerializeContext()
+    {
+        if (m_context == nullptr) {
+            return;
+        }
+        m_context->reset();
+        if (m_context->capacity() > detail::max_pooled_capacity) {
+            m_context->shrink_to_fit();
+        }
+        try {
+            detail::serialize_context_pool().push_back(std::move(m_context));
+        } catch (...) {
+        }
+    }
+
+    SerializeContext& operator*() const
+    {
+        return *m_context;
+    }
+
+    SerializeContext* operator->() const
+    {
+        return m_context.get();
+    }
+
+private:
+    std::unique_ptr<SerializeContext> m_context;
+};
+
+// Leases an empty context from the calling thread's pool, creating one if all of the pool's contexts are leased. In
+// the steady state of serializing one value at a time, the same context and buffer are reused for every value.
+[[nodiscard]] inline PooledSerializeContext acquire_serialize_context()
+{
+    return { };
+}
+
+}
+
+#endif // SBS_CONTEXT_HPP
@@ -0,0 +1,345 @@
+#ifndef SBS_FD_STREAM_HPP
+#define SBS_FD_STREAM_HPP
+
+#include <sbs/sbs.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace sbs {
+
+enum class IoStatus {
+    // All requested bytes were transferred.
+    complete,
+    // The non-blocking descriptor could not transfer more bytes without waiting.
+    would_block,
+};
+
+namespace detail {
+
+// Waits until `file` is ready for `events`, throwing if `timeout_ms` elapses first. Errors and hang-ups count as ready
+// so that the following read or write reports them.
+inline void wait_for_fd(const int file, const short events, const int timeout_ms)
+{
+    pollfd poll_fd { .fd = file, .events = events, .revents = 0 };
+    while (true) {
+        const int result = ::poll(&poll_fd, 1, timeout_ms);
+        if (result > 0) {
+            return;
+        }
+        if (result == 0) {
+            throw std::runtime_error("Timed out waiting for file descriptor");
+        }
+        if (errno != EINTR) {
+            throw std::runtime_error("Error waiting for file descriptor");
+        }
+    }
+}
+
+inline bool would_block(const int error)
+{
+    return error == EAGAIN || error == EWOULDBLOCK;
+}
+
+}
+
+struct FdWriterOptions {
+    // Small writes are collected in a buffer of this size and written to the descriptor together. Writes at least as
+    // large as the buffer bypass it when nothing is pending.
+    size_t buffer_size = 64 * 1024;
+    // With a non-blocking descriptor, bytes it does not accept yet stay pending in the writer, which grows its buffer
+    // to hold them. Once this many bytes are pending, writing waits for the descriptor to accept more, so a slow peer
+    // bounds the writer's memory rather than the size of the output.
+    size_t max_pending_size = 1024 * 1024;
+    // Milliseconds to wait for the descriptor to accept more bytes before throwing, or -1 to wait indefinitely.
+    int timeout_ms = -1;
+};
+
+// Writes to a file descriptor such as a pipe or socket, which it does not own. Values can be serialized straight onto
+// a socket without first serializing the whole value into memory.
+//
+// Blocking descriptors behave like `FileWriter`. For non-blocking descriptors, the writer never waits until its pending
+// bytes reach `FdWriterOptions::max_pending_size`, so an event loop can serialize a message and then call `try_flush`
+// whenever the descriptor becomes writable until it reports `IoStatus::complete`. Writing to a socket whose peer has
+// closed throws rather than raising `SIGPIPE`.
+class FdWriter {
+public:
+    explicit FdWriter(const int file, const FdWriterOptions& options = { })
+        : m_file { file }
+        , m_options { options }
+        , m_buffer_size { std::max<size_t>(options.buffer_size, 1) }
+        , m_capacity { m_buffer_size }
+        , m_buffer { std::make_unique_for_overwrite<std::byte[]>(m_capacity) }
+    {
+        struct stat status { };
+        m_socket = ::fstat(file, &status) == 0 && S_ISSOCK(status.st_mode);
+    }
+
+    FdWriter(const FdWriter&) = delete;
+    FdWriter& operator=(const FdWriter&) = delete;
+
+    // Pending bytes are written on destruction, waiting as `flush` does, but errors can only be observed by calling
+    // `flush` beforehand.
+    ~FdWriter()
+    {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    void write(std::span<const std::byte> bytes)
+    {
+        if (pending_size() == 0 && bytes.size() >= m_buffer_size) {
+            bytes = bytes.subspan(send(bytes));
+        }
+        while (!bytes.empty()) {
+            const std::span<std::byte> buffer = prepare(bytes.size());
+            const size_t size = std::min(bytes.size(), buffer.size());
+            std::memcpy(buffer.data(), bytes.data(), size);
+            commit(size);
+            bytes = bytes.subspan(size);
+        }
+    }
+
+    std::span<std::byte> prepare(const size_t size)
+    {
+        if (m_capacity - m_end < size) {
+            make_room(std::min(size, m_buffer_size));
+        }
+        return { m_buffer.get() + m_end, m_capacity - m_end };
+    }
+
+    void commit(const size_t size)
+    {
+        m_end += size;
+    }
+
+    // Writes all pending bytes, waiting for the descriptor to accept them if it is non-blocking.
+    void flush()
+    {
+        while (try_flush() == IoStatus::would_block) {
+            detail::wait_for_fd(m_file, POLLOUT, m_options.timeout_ms);
+        }
+    }
+
+    // Writes as many pending bytes as the descriptor accepts without waiting.
+    IoStatus try_flush()
+    {
+        m_begin += send({ m_buffer.get() + m_begin, pending_size() });
+        if (m_begin == m_end) {
+            m_begin = m_end = 0;
+            return IoStatus::complete;
+        }
+        return IoStatus::would_block;
+    }
+
+    // Bytes written to the writer that the descriptor has not accepted yet.
+    [[nodiscard]] size_t pending_size() const
+    {
+        return m_end - m_begin;
+    }
+
+private:
+    int m_file;
+    FdWriterOptions m_options;
+    bool m_socket { false };
+    size_t m_buffer_size;
+    size_t m_capacity;
+    std::unique_ptr<std::byte[]> m_buffer;
+    // Pending bytes are between the begin and end of the buffer.
+    size_t m_begin { };
+    size_t m_end { };
+
+    // Makes room for `size` more bytes after the pending bytes, which is at most the buffer size, by writing them out,
+    // by moving them to the front of the buffer or by growing the buffer while below the pending limit, and otherwise
+    // by waiting for the descriptor.
+    void make_room(const size_t size)
+    {
+        while (true) {
+            if (try_flush() == IoStatus::complete || m_capacity - m_end >= size) {
+                return;
+            }
+            if (m_capacity - pending_size() >= size) {
+                std::memmove(m_buffer.get(), m_buffer.get() + m_begin, pending_size());
+                m_end = pending_size();
+                m_begin = 0;
+                return;
+            }
+            if (pending_size() + size <= m_options.max_pending_size) {
+                reallocate(std::max(pending_size() + size, std::min(m_capacity * 2, m_options.max_pending_size)));
+                return;
+            }
+            detail::wait_for_fd(m_file, POLLOUT, m_options.timeout_ms);
+        }
+    }
+
+    void reallocate(const size_t capacity)
+    {
+        auto buffer = std::make_unique_for_overwrite<std::byte[]>(capacity);
+        std::memcpy(buffer.get(), m_buffer.get() + m_begin, pending_size());
+        m_end = pending_size();
+        m_begin = 0;
+        m_buffer = std::move(buffer);
+        m_capacity = capacity;
+    }
+
+    // Writes as much of `bytes` as the descriptor accepts without waiting and returns the number of bytes written.
+    size_t send(const std::span<const std::byte> bytes)
+    {
+        size_t written = 0;
+        while (written < bytes.size()) {
+            const std::span<const std::byte> rest = bytes.subspan(written);
+#if defined(MSG_NOSIGNAL)
+            const ssize_t result = m_socket ? ::send(m_file, rest.data(), rest.size(), MSG_NOSIGNAL)
+                                            : ::write(m_file, rest.data(), rest.size());
+#else
+            const ssize_t result = ::write(m_file, rest.data(), rest.size());
+#endif
+            if (result >= 0) {
+                written += static_cast<size_t>(result);
+            } else if (detail::would_block(errno)) {
+                break;
+            } else if (errno != EINTR) {
+                throw std::runtime_error("Error writing to file descriptor");
+            }
+        }
+        return written;
+    }
+};
+
+struct FdReaderOptions {
+    // The descriptor is read ahead in chunks of up to this size. Requests larger than the buffer grow it.
+    size_t buffer_size = 64 * 1024;
+    // Milliseconds to wait for a non-blocking descriptor to have more bytes before throwing, or -1 to wait
+    // indefinitely.
+    int timeout_ms = -1;
+};
+
+// Reads from a file descriptor such as a pipe or socket, which it does not own. Reading from a non-blocking descriptor
+// waits for the rest of a value with `poll`, since deserialization cannot be suspended. To deserialize without ever
+// waiting, feed whatever `read_available` returns to an `IncrementalDeserializer`.
+class FdReader {
+public:
+    explicit FdReader(const int file, const FdReaderOptions& options = { })
+        : m_file { file }
+        , m_options { options }
+        , m_capacity { std::max<size_t>(options.buffer_size, 1) }
+        , m_buffer { std::make_unique_for_overwrite<std::byte[]>(m_capacity) }
+    {
+    }
+
+    FdReader(const FdReader&) = delete;
+    FdReader& operator=(const FdReader&) = delete;
+
+    std::span<const std::byte> read(const size_t size)
+    {
+        const std::span<const std::byte> bytes = data(size);
+        const size_t read_size = std::min(size, bytes.size());
+        consume(read_size);
+        return bytes.first(read_size);
+    }
+
+    // Returns at least `size` buffered bytes, reading and waiting for them as needed, or fewer at the end of the
+    // stream.
+    std::span<const std::byte> data(const size_t size)
+    {
+        if (m_end - m_begin < size) {
+            make_room(size);
+            while (m_end - m_begin < size && !m_eof) {
+                if (receive() == IoStatus::would_block) {
+                    detail::wait_for_fd(m_file, POLLIN, m_options.timeout_ms);
+                }
+            }
+        }
+        return { m_buffer.get() + m_begin, m_end - m_begin };
+    }
+
+    void consume(const size_t size)
+    {
+        m_begin += size;
+    }
+
+    // Reads once from a non-blocking descriptor without waiting and consumes the bytes read along with any bytes
+    // already buffered. The returned bytes are valid until the next call to a non-const method.
+    std::span<const std::byte> read_available()
+    {
+        make_room(m_end - m_begin + 1);
+        if (!m_eof) {
+            receive();
+        }
+        const std::span<const std::byte> bytes { m_buffer.get() + m_begin, m_end - m_begin };
+        m_begin = m_end;
+        return bytes;
+    }
+
+    // Whether the peer has closed its end and all bytes have been read from the descriptor.
+    [[nodiscard]] bool eof() const
+    {
+        return m_eof;
+    }
+
+private:
+    int m_file;
+    FdReaderOptions m_options;
+    size_t m_capacity;
+    std::unique_ptr<std::byte[]> m_buffer;
+    size_t m_begin { };
+    size_t m_end { };
+    bool m_eof { false };
+
+    // Moves the unconsumed bytes to the front of the buffer, which grows to hold at least `size` bytes.
+    void make_room(const size_t size)
+    {
+        const size_t remaining = m_end - m_begin;
+        if (m_capacity < size) {
+            auto buffer = std::make_unique_for_overwrite<std::byte[]>(size);
+            std::memcpy(buffer.get(), m_buffer.get() + m_begin, remaining);
+            m_buffer = std::move(buffer);
+            m_capacity = size;
+        } else if (m_begin > 0) {
+            std::memmove(m_buffer.get(), m_buffer.get() + m_begin, remaining);
+        }
+        m_begin = 0;
+        m_end = remaining;
+    }
+
+    // Reads once into the free space of the buffer.
+    IoStatus receive()
+    {
+        while (true) {
+            const ssize_t result = ::read(m_file, m_buffer.get() + m_end, m_capacity - m_end);
+            if (result >= 0) {
+                m_eof = result == 0;
+                m_end += static_cast<size_t>(result);
+                return IoStatus::complete;
+            }
+            if (detail::would_block(errno)) {
+                return IoStatus::would_block;
+            }
+            if (errno != EINTR) {
+                throw std::runtime_error("Error reading from file descriptor");
+            }
+        }
+    }
+};
+
+}
+
+#endif
+
+#endif // SBS_FD_STREAM_HPP
@@ -0,0 +1,146 @@
+#ifndef SBS_INCREMENTAL_HPP
+#define SBS_INCREMENTAL_HPP
+
+#include <sbs/sbs.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sbs {
+
+enum class IncrementalStatus {
+    // The value could not be deserialized from the bytes fed so far.
+    need_more_data,
+    // The value has been deserialized.
+    complete,
+};
+
+namespace detail {
+
+// Thrown out of an attempt to deserialize when the input ends, unlike other errors which mean the input is invalid.
+struct NeedMoreData {
+    size_t required_size;
+};
+
+// Only implements `read` rather than exposing a buffer so that each read states exactly how many bytes it needs.
+class IncrementalReader {
+public:
+    explicit IncrementalReader(const std::span<const std::byte> bytes)
+        : m_bytes { bytes }
+    {
+    }
+
+    std::span<const std::byte> read(const size_t size)
+    {
+        if (m_bytes.size() - m_position < size) {
+            throw NeedMoreData { m_position + size };
+        }
+        const std::span<const std::byte> bytes = m_bytes.subspan(m_position, size);
+        m_position += size;
+        return bytes;
+    }
+
+    [[nodiscard]] size_t position() const
+    {
+        return m_position;
+    }
+
+private:
+    std::span<const std::byte> m_bytes;
+    size_t m_position { };
+};
+
+}
+
+// Deserializes a value from input that arrives in fragments of any size, such as from a non-blocking socket, without
+// blocking or needing a thread per stream. Each fragment is passed to `feed` which reports whether the value is
+// complete.
+//
+// Serialization implementations cannot be suspended, so each attempt deserializes from the start of the buffered
+// input into a freshly constructed value. An attempt is only made once enough bytes have arrived for the read that
+// the previous attempt stopped at, so there is at most one attempt per fragment and per read of the value. Each
+// attempt re-reads the buffered bytes, so in the worst case, when fragments are smaller than the values read, such as
+// a vector of strings fed a few bytes at a time, a message of `n` bytes costs O(n^2) work. Feeding larger fragments,
+// such as everything a socket has available, keeps it close to linear.
+template <class Type, class TypeSerializer = DefaultSerializer<Type>>
+    requires(Serializer<TypeSerializer, Type> && std::is_default_constructible_v<Type>)
+class IncrementalDeserializer {
+public:
+    explicit IncrementalDeserializer(const ArchiveOptions& archive_options = { })
+        : m_archive_options { archive_options }
+    {
+    }
+
+    // Buffers `bytes` and attempts to deserialize the value. Bytes fed after the value is complete are kept for the
+    // next value, see `reset`. Exceptions other than running out of input are propagated.
+    IncrementalStatus feed(const std::span<const std::byte> bytes)
+    {
+        m_buffer.insert(m_buffer.end(), bytes.begin(), bytes.end());
+        if (m_status == IncrementalStatus::complete || m_buffer.size() < m_required_size) {
+            return m_status;
+        }
+        detail::IncrementalReader reader { m_buffer };
+        Type value { };
+        try {
+            deserialize_using_reader<TypeSerializer>(value, reader, m_archive_options);
+        } catch (const detail::NeedMoreData& need_more_data) {
+            m_required_size = need_more_data.required_size;
+            return m_status;
+        }
+        m_value = std::move(value);
+        m_value_size = reader.position();
+        m_status = IncrementalStatus::complete;
+        return m_status;
+    }
+
+    [[nodiscard]] IncrementalStatus status() const
+    {
+        return m_status;
+    }
+
+    // Minimum number of additional bytes before another attempt is made.
+    [[nodiscard]] size_t bytes_needed() const
+    {
+        return m_required_size - std::min(m_required_size, m_buffer.size());
+    }
+
+    // The deserialized value once complete.
+    [[nodiscard]] Type& value()
+    {
+        return m_value;
+    }
+
+    // Bytes fed after the end of the complete value.
+    [[nodiscard]] std::span<const std::byte> remaining() const
+    {
+        return std::span(m_buffer).subspan(m_value_size);
+    }
+
+    // Starts deserializing the next value from the bytes remaining after the complete value, if any. Call `feed` to
+    // attempt deserializing it, with an empty span if no new bytes have arrived.
+    void reset()
+    {
+        m_buffer.erase(m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t>(m_value_size));
+        m_value = Type { };
+        m_value_size = 0;
+        m_required_size = 0;
+        m_status = IncrementalStatus::need_more_data;
+    }
+
+private:
+    ArchiveOptions m_archive_options;
+    std::vector<std::byte> m_buffer;
+    Type m_value { };
+    size_t m_value_size { };
+    size_t m_required_size { };
+    IncrementalStatus m_status { IncrementalStatus::need_more_data };
+};
+
+}
+
+#endif // SBS_INCREMENTAL_HPP
@@ -0,0 +1,167 @@
+#ifndef SBS_MAPPED_FILE_HPP
+#define SBS_MAPPED_FILE_HPP
+
+#include <sbs/sbs.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sbs {
+
+struct MappedFileOptions {
+    // The mapping will be read front to back, so pages can be read ahead aggressively and dropped after use.
+    bool sequential = true;
+    // Start reading the whole file into the page cache immediately.
+    bool will_need = false;
+    // Back the mapping with transparent huge pages where supported.
+    bool huge_pages = false;
+};
+
+// A read-only view of a whole file. On POSIX systems the file is memory mapped, elsewhere it is read into memory.
+// The mapping is released on destruction and can be shared by any number of deserializations while alive.
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path, const MappedFileOptions& options = { })
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file == -1) {
+            throw std::runtime_error("Unable to open file: " + path.string());
+        }
+        struct stat status { };
+        if (::fstat(file, &status) == -1) {
+            ::close(file);
+            throw std::runtime_error("Error reading file: " + path.string());
+        }
+        m_size = static_cast<size_t>(status.st_size);
+        if (m_size > 0) {
+            void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data == MAP_FAILED) {
+                ::close(file);
+                throw std::runtime_error("Unable to map file: " + path.string());
+            }
+            m_data = static_cast<const std::byte*>(data);
+            advise(options);
+        }
+        ::close(file);
+#else
+        static_cast<void>(options);
+        FileReader reader { path };
+        while (true) {
+            const std::span<const std::byte> bytes = reader.data(1);
+            if (bytes.empty()) {
+                break;
+            }
+            m_buffer.insert(m_buffer.end(), bytes.begin(), bytes.end());
+            reader.consume(bytes.size());
+        }
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : m_data { std::exchange(other.m_data, nullptr) }
+        , m_size { std::exchange(other.m_size, 0) }
+        , m_buffer { std::move(other.m_buffer) }
+    {
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other) {
+            unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_buffer = std::move(other.m_buffer);
+        }
+        return *this;
+    }
+
+    ~MappedFile()
+    {
+        unmap();
+    }
+
+    [[nodiscard]] std::span<const std::byte> bytes() const
+    {
+        return { m_data, m_size };
+    }
+
+private:
+    const std::byte* m_data { };
+    size_t m_size { };
+    std::vector<std::byte> m_buffer;
+
+    void advise([[maybe_unused]] const MappedFileOptions& options) const
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        // Hints are best effort so failures are ignored.
+        void* data = const_cast<std::byte*>(m_data);
+        if (options.sequential) {
+            ::madvise(data, m_size, MADV_SEQUENTIAL);
+        }
+        if (options.will_need) {
+            ::madvise(data, m_size, MADV_WILLNEED);
+        }
+#if defined(MADV_HUGEPAGE)
+        if (options.huge_pages) {
+            ::madvise(data, m_size, MADV_HUGEPAGE);
+        }
+#endif
+#endif
+    }
+
+    void unmap()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (m_data != nullptr) {
+            ::munmap(const_cast<std::byte*>(m_data), m_size);
+        }
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_buffer.clear();
+    }
+};
+
+template <class TypeSerializer, class Type>
+    requires(Serializer<TypeSerializer, Type>)
+void deserialize_from_mapped_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const MappedFileOptions& options = { })
+{
+    const MappedFile file { path, options };
+    deserialize_from_span<TypeSerializer>(file.bytes(), value, archive_options);
+}
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+void deserialize_from_mapped_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const MappedFileOptions& options = { })
+{
+    deserialize_from_mapped_file<DefaultSerializer<Type>>(path, value, archive_options, options);
+}
+
+}
+
+#endif // SBS_MAPPED_FILE_HPP
@@ -10,285 +10,1880 @@
 #include <bit>
 #include <climits>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
 #include <ranges>
 #include <span>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
 namespace sbs {
 
-static_assert(CHAR_BIT == 8, "SBS only supports platforms with 8-bit bytes.");
+static_assert(CHAR_BIT == 8, "SBS only supports platforms with 8-bit bytes.");
+
+class Archive;
+
+template <class Type>
+concept IntegerSerializable
+    = std::is_integral_v<Type> || (std::is_enum_v<Type> && std::is_integral_v<std::underlying_type_t<Type>>);
+
+template <class Type>
+concept FloatSerializable = std::is_floating_point_v<Type> && std::numeric_limits<Type>::is_iec559;
+
+template <class Type>
+concept ValueSerializable = IntegerSerializable<Type> || FloatSerializable<Type>;
+
+template <class Type>
+concept MethodSerializable = requires(Type type, Archive& archive) { type.serialize(archive); };
+
+template <class Type>
+concept FunctionSerializable = requires(Type type, Archive& archive) { serialize(archive, type); };
+
+template <class Type>
+concept ObjectSerializable = MethodSerializable<Type> || FunctionSerializable<Type>;
+
+template <class Type>
+concept DefaultSerializable = ValueSerializable<Type> || ObjectSerializable<Type>;
+
+template <class SerializeType, class Type>
+concept Serializer = requires(SerializeType serialize, Archive& archive, Type& value) {
+    { serialize.operator()(archive, value) } -> std::same_as<void>;
+} && std::is_default_constructible_v<SerializeType>;
+
+using WriteCallback = std::function<void(std::span<const std::byte>)>;
+using ReadCallback = std::function<std::span<const std::byte>(size_t)>;
+
+template <class Type>
+concept Writer = requires(Type& writer, const std::span<const std::byte> bytes) {
+    { writer.write(bytes) } -> std::same_as<void>;
+};
+
+template <class Type>
+concept BufferedWriter = Writer<Type> && requires(Type& writer, const size_t size) {
+    { writer.prepare(size) } -> std::same_as<std::span<std::byte>>;
+    { writer.commit(size) } -> std::same_as<void>;
+};
+
+// Writers that can record a reference to bytes instead of copying them, such as for gathering the output into a single
+// vectored write. Bytes archived with `Archive::reference_span` of at least `min_reference_size` are passed to
+// `reference` and must stay alive and unmodified until the writer's output has been consumed.
+template <class Type>
+concept ReferencingWriter = Writer<Type> && requires(Type& writer, const std::span<const std::byte> bytes) {
+    { writer.reference(bytes) } -> std::same_as<void>;
+    { writer.min_reference_size() } -> std::same_as<size_t>;
+};
+
+// Writers that can overwrite bytes already written to them, so that a size can be archived after the elements it
+// counts, see `Archive::reserve_size`. `position` is the number of bytes written so far, and `patch` overwrites bytes
+// starting at a position it returned.
+template <class Type>
+concept PatchableWriter
+    = Writer<Type> && requires(Type& writer, const uint64_t position, const std::span<const std::byte> bytes) {
+          { writer.position() } -> std::same_as<uint64_t>;
+          { writer.patch(position, bytes) } -> std::same_as<void>;
+      };
+
+template <class Type>
+concept Reader = requires(Type& reader, const size_t size) {
+    { reader.read(size) } -> std::same_as<std::span<const std::byte>>;
+};
+
+template <class Type>
+concept BufferedReader = Reader<Type> && requires(Type& reader, const size_t size) {
+    { reader.data(size) } -> std::same_as<std::span<const std::byte>>;
+    { reader.consume(size) } -> std::same_as<void>;
+};
+
+// Readers whose `data` always returns all of the remaining input from storage that outlives the reader. Values
+// deserialized from these readers may borrow the input instead of copying it.
+template <class Type>
+concept ContiguousReader = BufferedReader<Type> && Type::contiguous;
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+struct DefaultSerializer;
+
+// Elements that can be archived in bulk with `Archive::archive_span` because they are plain values archived by the
+// default serializer.
+template <class SerializeType, class Type>
+concept SpanSerializable = ValueSerializable<Type> && std::same_as<SerializeType, DefaultSerializer<Type>>;
+
+// Number of bytes that every value archived by `SerializeType` takes, or 0 if it is not fixed. See
+// `Archive::allocation_count`.
+template <class SerializeType, class Type>
+constexpr size_t fixed_serialized_size = SpanSerializable<SerializeType, Type> ? sizeof(Type) : 0;
+
+class CallbackWriter {
+public:
+    explicit CallbackWriter(WriteCallback write_callback)
+        : m_write_callback { std::move(write_callback) }
+    {
+    }
+
+    void write(const std::span<const std::byte> bytes)
+    {
+        m_write_callback(bytes);
+    }
+
+private:
+    WriteCallback m_write_callback;
+};
+
+class CallbackReader {
+public:
+    explicit CallbackReader(ReadCallback read_callback)
+        : m_read_callback { std::move(read_callback) }
+    {
+    }
+
+    std::span<const std::byte> read(const size_t size)
+    {
+        return m_read_callback(size);
+    }
+
+private:
+    ReadCallback m_read_callback;
+};
+
+namespace detail {
+
+#if defined(__AVX2__)
+template <size_t Size>
+__m256i byteswap_mask_256()
+{
+    alignas(32) std::array<uint8_t, 32> mask { };
+    for (size_t i = 0; i < mask.size(); ++i) {
+        mask[i] = static_cast<uint8_t>(i - i % Size + (Size - 1 - i % Size));
+    }
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(mask.data()));
+}
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+template <size_t Size>
+__m128i byteswap_128(__m128i value)
+{
+    if constexpr (Size == 4) {
+        value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+        value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+    } else if constexpr (Size == 8) {
+        value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+        value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+    }
+    return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+}
+#endif
+
+// Copies `count` elements of `Size` bytes from `source` to `dest` reversing the bytes of each element. `dest` and
+// `source` must either be equal or not overlap.
+template <size_t Size>
+void byteswap_copy(std::byte* dest, const std::byte* source, const size_t count)
+{
+    size_t i = 0;
+    if constexpr (Size == 2 || Size == 4 || Size == 8) {
+#if defined(__AVX2__)
+        const __m256i mask = byteswap_mask_256<Size>();
+        for (; i + 32 / Size <= count; i += 32 / Size) {
+            const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * Size));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i * Size), _mm256_shuffle_epi8(value, mask));
+        }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+        for (; i + 16 / Size <= count; i += 16 / Size) {
+            const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * Size));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * Size), byteswap_128<Size>(value));
+        }
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+        for (; i + 16 / Size <= count; i += 16 / Size) {
+            uint8x16_t value = vld1q_u8(reinterpret_cast<const uint8_t*>(source + i * Size));
+            if constexpr (Size == 2) {
+                value = vrev16q_u8(value);
+            } else if constexpr (Size == 4) {
+                value = vrev32q_u8(value);
+            } else {
+                value = vrev64q_u8(value);
+            }
+            vst1q_u8(reinterpret_cast<uint8_t*>(dest + i * Size), value);
+        }
+#endif
+    }
+    for (; i < count; ++i) {
+        std::array<std::byte, Size> reversed;
+        std::reverse_copy(source + i * Size, source + (i + 1) * Size, reversed.begin());
+        std::memcpy(dest + i * Size, reversed.data(), Size);
+    }
+}
+
+struct WriterTable {
+    void (*write)(void* writer, std::span<const std::byte> bytes);
+    std::span<std::byte> (*prepare)(void* writer, size_t size);
+    void (*commit)(void* writer, size_t size);
+    void (*reference)(void* writer, std::span<const std::byte> bytes);
+    uint64_t (*position)(void* writer);
+    void (*patch)(void* writer, uint64_t position, std::span<const std::byte> bytes);
+};
+
+struct ReaderTable {
+    std::span<const std::byte> (*read)(void* reader, size_t size);
+    std::span<const std::byte> (*data)(void* reader, size_t size);
+    void (*consume)(void* reader, size_t size);
+    bool contiguous;
+};
+
+template <Writer Type>
+consteval WriterTable make_writer_table()
+{
+    WriterTable table { };
+    table.write
+        = [](void* writer, const std::span<const std::byte> bytes) { static_cast<Type*>(writer)->write(bytes); };
+    if constexpr (BufferedWriter<Type>) {
+        table.prepare = [](void* writer, const size_t size) { return static_cast<Type*>(writer)->prepare(size); };
+        table.commit = [](void* writer, const size_t size) { static_cast<Type*>(writer)->commit(size); };
+    }
+    if constexpr (ReferencingWriter<Type>) {
+        table.reference = [](void* writer, const std::span<const std::byte> bytes) {
+            static_cast<Type*>(writer)->reference(bytes);
+        };
+    }
+    if constexpr (PatchableWriter<Type>) {
+        table.position = [](void* writer) { return static_cast<Type*>(writer)->position(); };
+        table.patch = [](void* writer, const uint64_t position, const std::span<const std::byte> bytes) {
+            static_cast<Type*>(writer)->patch(position, bytes);
+        };
+    }
+    return table;
+}
+
+template <Reader Type>
+consteval ReaderTable make_reader_table()
+{
+    ReaderTable table { };
+    table.read = [](void* reader, const size_t size) { return static_cast<Type*>(reader)->read(size); };
+    if constexpr (BufferedReader<Type>) {
+        table.data = [](void* reader, const size_t size) { return static_cast<Type*>(reader)->data(size); };
+        table.consume = [](void* reader, const size_t size) { static_cast<Type*>(reader)->consume(size); };
+    }
+    table.contiguous = ContiguousReader<Type>;
+    return table;
+}
+
+template <Writer Type>
+inline constexpr WriterTable writer_table = make_writer_table<Type>();
+
+template <Reader Type>
+inline constexpr ReaderTable reader_table = make_reader_table<Type>();
+
+}
+
+enum class SizeEncoding {
+    // Sizes are archived as 8 byte unsigned integers.
+    fixed,
+    // Sizes are archived as unsigned LEB128 variable-length integers.
+    varint,
+};
+
+struct ArchiveOptions {
+    ArchiveOptions() = default;
+
+    // Implicit so that an endian can be passed wherever archive options are accepted.
+    ArchiveOptions(const std::endian archive_endian)
+        : endian { archive_endian }
+    {
+    }
+
+    std::endian endian = std::endian::little;
+    // Encoding of container sizes and variant indices archived with `Archive::archive_size`.
+    SizeEncoding size_encoding = SizeEncoding::fixed;
+    // Memory resource for values deserialized outside of a container, such as the values of `std::optional`,
+    // `std::variant` and `std::unique_ptr` with `ResourceDeleter`, where null uses the default resource. Values
+    // deserialized into a container use the container's allocator instead.
+    std::pmr::memory_resource* memory_resource = nullptr;
+    // Largest container size or string length accepted when deserializing. See `Archive::archive_size`.
+    uint64_t max_length = std::numeric_limits<uint64_t>::max();
+    // Number of bytes that containers may allocate for their elements while deserializing, counted by
+    // `Archive::allocation_count` and `Archive::charge_memory`.
+    uint64_t memory_budget = std::numeric_limits<uint64_t>::max();
+};
+
+// Room reserved in the output for a size that is archived later. See `Archive::reserve_size`.
+struct SizeSlot {
+    uint64_t position;
+};
+
+class Archive {
+public:
+    static Archive create_for_serializing(WriteCallback write_callback, const ArchiveOptions& options)
+    {
+        auto writer = std::make_unique<CallbackWriter>(std::move(write_callback));
+        auto archive = Archive(*writer, options);
+        archive.m_callback_writer = std::move(writer);
+        return archive;
+    }
+
+    static Archive create_for_deserializing(ReadCallback read_callback, const ArchiveOptions& options)
+    {
+        auto reader = std::make_unique<CallbackReader>(std::move(read_callback));
+        auto archive = Archive(*reader, options);
+        archive.m_callback_reader = std::move(reader);
+        return archive;
+    }
+
+    // The writer is referenced, not owned, and must outlive the archive. `sync` must be called once archiving is done
+    // so that buffered writers receive the final commit.
+    template <Writer WriterType>
+    static Archive create_for_serializing(WriterType& writer, const ArchiveOptions& options)
+    {
+        return Archive(writer, options);
+    }
+
+    // The reader is referenced, not owned, and must outlive the archive. `sync` must be called once archiving is done
+    // so that buffered readers are advanced past the consumed bytes.
+    template <Reader ReaderType>
+    static Archive create_for_deserializing(ReaderType& reader, const ArchiveOptions& options)
+    {
+        return Archive(reader, options);
+    }
+
+    // Creates a serializing archive that does not write anything and only adds up the number of bytes that would be
+    // written. See `counted_size`.
+    static Archive create_for_counting(const ArchiveOptions& options)
+    {
+        return Archive(options);
+    }
+
+    Archive(const Archive&) = delete;
+    Archive& operator=(const Archive&) = delete;
+    Archive(Archive&&) noexcept = default;
+    Archive& operator=(Archive&&) noexcept = default;
+    ~Archive() = default;
+
+    template <class Value>
+        requires(ValueSerializable<Value>)
+    void archive_value(Value& value)
+    {
+        if (m_mode == Mode::serialize) {
+            std::span<const std::byte> bytes = std::as_bytes(std::span<const Value>(&value, 1));
+            if (m_options.endian == std::endian::native) {
+                write_bytes(bytes);
+            } else {
+                std::array<std::byte, sizeof(Value)> reversed;
+                std::ranges::copy(bytes | std::views::reverse, reversed.begin());
+                write_bytes(reversed);
+            }
+        } else if (m_mode == Mode::count) {
+            m_counted_size += sizeof(Value);
+        } else {
+            std::span<const std::byte> source = read_bytes(sizeof(Value));
+            std::span<std::byte> dest = std::as_writable_bytes(std::span<Value>(&value, 1));
+            if (m_options.endian == std::endian::native) {
+                std::memcpy(dest.data(), source.data(), sizeof(Value));
+            } else {
+                std::ranges::copy(source | std::views::reverse, dest.begin());
+            }
+        }
+    }
+
+    // Archives contiguous values with the same bytes as archiving each value in order. In the native endian this is a
+    // single copy of the whole span.
+    template <class Value>
+        requires(ValueSerializable<Value>)
+    void archive_span(const std::span<Value> values)
+    {
+        if (values.empty()) {
+            return;
+        }
+        if (m_mode == Mode::serialize) {
+            if (m_options.endian == std::endian::native || sizeof(Value) == 1) {
+                write_bytes(std::as_bytes(values));
+            } else {
+                write_bytes_swapped<sizeof(Value)>(std::as_bytes(values));
+            }
+        } else if (m_mode == Mode::count) {
+            m_counted_size += values.size_bytes();
+        } else {
+            const std::span<std::byte> bytes = std::as_writable_bytes(values);
+            read_bytes_into(bytes);
+            if (m_options.endian != std::endian::native && sizeof(Value) != 1) {
+                detail::byteswap_copy<sizeof(Value)>(bytes.data(), bytes.data(), values.size());
+            }
+        }
+    }
+
+    // Archives contiguous values like `archive_span`, except that writers which support it may reference the values
+    // instead of copying them, see `ReferencingWriter`. Only use this for values that the caller of the serialization
+    // function owns, never for temporaries or copies local to a serializer, which is why the default serializers do
+    // not.
+    template <class Value>
+        requires(ValueSerializable<Value>)
+    void reference_span(const std::span<Value> values)
+    {
+        if (m_mode == Mode::serialize && values.size_bytes() >= m_min_reference_size
+            && (m_options.endian == std::endian::native || sizeof(Value) == 1)) {
+            sync();
+            m_writer_table->reference(m_io, std::as_bytes(values));
+        } else {
+            archive_span(values);
+        }
+    }
+
+    // Deserializes `count` values by returning a view of them in the input rather than copying them. This requires a
+    // contiguous reader and the view is only valid while the reader's storage is. Multi-byte values must be in the
+    // native endian and suitably aligned in the input.
+    template <class Value>
+        requires(ValueSerializable<Value>)
+    std::span<const Value> borrow_span(const uint64_t count)
+    {
+        if (m_mode != Mode::deserialize) {
+            throw std::logic_error("Borrowing is only possible when deserializing");
+        }
+        if (!m_reader_table->contiguous) {
+            throw std::runtime_error("Borrowing requires a contiguous reader");
+        }
+        if (count > std::numeric_limits<size_t>::max() / sizeof(Value)) {
+            throw std::runtime_error("Insufficient data to deserialize");
+        }
+        if (sizeof(Value) > 1 && m_options.endian != std::endian::native) {
+            throw std::runtime_error("Borrowed values must be in the native endian");
+        }
+        const std::span<const std::byte> bytes = read_bytes(static_cast<size_t>(count) * sizeof(Value));
+        if (reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(Value) != 0) {
+            throw std::runtime_error("Borrowed values are not aligned");
+        }
+        return { reinterpret_cast<const Value*>(bytes.data()), static_cast<size_t>(count) };
+    }
+
+    // Archives an unsigned LEB128 integer: 7 bits per byte, least significant group first, with the high bit set on
+    // every byte but the last. Values below 128 take a single byte and the largest take 10.
+    void archive_varint(uint64_t& value)
+    {
+        if (m_mode == Mode::serialize) {
+            std::array<std::byte, max_varint_size> bytes;
+            size_t size = 0;
+            uint64_t remaining = value;
+            while (remaining >= 0x80) {
+                bytes[size++] = static_cast<std::byte>(remaining | 0x80);
+                remaining >>= 7;
+            }
+            bytes[size++] = static_cast<std::byte>(remaining);
+            write_bytes(std::span(bytes).first(size));
+        } else if (m_mode == Mode::count) {
+            m_counted_size += (std::bit_width(value | 1) + 6) / 7;
+        } else if (static_cast<size_t>(m_read_end - m_read_cursor) >= sizeof(uint64_t)) {
+            read_varint_fast(value);
+        } else {
+            read_varint_slow(value);
+        }
+    }
+
+    // Archives a container size or variant index in the encoding selected by `ArchiveOptions::size_encoding`. When
+    // deserializing, sizes above `ArchiveOptions::max_length` throw.
+    void archive_size(uint64_t& size)
+    {
+        if (m_options.size_encoding == SizeEncoding::varint) {
+            archive_varint(size);
+        } else {
+            archive_value(size);
+        }
+        if (m_mode == Mode::deserialize && size > m_options.max_length) {
+            throw std::runtime_error("Length exceeds the maximum");
+        }
+    }
+
+    // Reserves room for a size that is archived with `patch_size` once it is known, so that containers whose size is
+    // only known after archiving their elements, such as those walked by a single-pass iterator, need not be walked
+    // twice or collected first. With fixed size encoding, the output is identical to archiving the size up front. With
+    // varint size encoding, the size is archived as a varint padded to its maximum width, which decodes to the same
+    // size. Requires `can_reserve_size`.
+    [[nodiscard]] SizeSlot reserve_size()
+    {
+        if (m_mode == Mode::deserialize) {
+            throw std::logic_error("Reserving a size is only possible when serializing");
+        }
+        const size_t width = reserved_size_width();
+        if (m_mode == Mode::count) {
+            m_counted_size += width;
+            return { .position = 0 };
+        }
+        if (m_writer_table->patch == nullptr) {
+            throw std::logic_error("Reserving a size requires a patchable writer");
+        }
+        sync();
+        const SizeSlot slot { .position = m_writer_table->position(m_io) };
+        constexpr std::array<std::byte, max_varint_size> placeholder { };
+        write_bytes(std::span(placeholder).first(width));
+        return slot;
+    }
+
+    // Archives `size` into the room reserved by `reserve_size`.
+    void patch_size(const SizeSlot slot, const uint64_t size)
+    {
+        if (m_mode != Mode::serialize) {
+            return;
+        }
+        std::array<std::byte, max_varint_size> bytes;
+        if (m_options.size_encoding == SizeEncoding::varint) {
+            uint64_t remaining = size;
+            for (size_t i = 0; i < max_varint_size - 1; ++i) {
+                bytes[i] = static_cast<std::byte>(remaining | 0x80);
+                remaining >>= 7;
+            }
+            bytes[max_varint_size - 1] = static_cast<std::byte>(remaining);
+        } else {
+            std::memcpy(bytes.data(), &size, sizeof(size));
+            if (m_options.endian != std::endian::native) {
+                std::ranges::reverse(std::span(bytes).first(sizeof(size)));
+            }
+        }
+        sync();
+        m_writer_table->patch(m_io, slot.position, std::span(bytes).first(reserved_size_width()));
+    }
+
+    // Returns how many of the `count` elements left to deserialize into a container may be allocated before they are
+    // read, and charges their `element_size` bytes against `ArchiveOptions::memory_budget`. If every element takes at
+    // least `element_input_size` bytes of input and the reader is contiguous, so the size of the rest of the input is
+    // known, all of the elements are allocated at once after checking that the input holds them. Otherwise at most
+    // `allocation_chunk_size` bytes of elements are allocated at a time, so that a corrupt or hostile size makes the
+    // container grow only as elements are actually read.
+    [[nodiscard]] size_t allocation_count(
+        const uint64_t count, const size_t element_size, const size_t element_input_size = 0)
+    {
+        if (m_mode != Mode::deserialize) {
+            return static_cast<size_t>(count);
+        }
+        uint64_t allowed = count;
+        if (element_input_size > 0 && m_reader_table->contiguous) {
+            if (count > remaining_input_size() / element_input_size) {
+                throw std::runtime_error("Insufficient data to deserialize");
+            }
+        } else if (element_size > 0) {
+            allowed = std::min<uint64_t>(count, std::max<size_t>(allocation_chunk_size / element_size, 1));
+        }
+        if (element_size > 0 && allowed > std::numeric_limits<uint64_t>::max() / element_size) {
+            throw std::runtime_error("Memory budget exceeded");
+        }
+        charge_memory(allowed * element_size);
+        return static_cast<size_t>(allowed);
+    }
+
+    // Bytes of `ArchiveOptions::memory_budget` not yet charged, such as for giving to an archive that deserializes part
+    // of the input on behalf of this one.
+    [[nodiscard]] uint64_t memory_budget_remaining() const
+    {
+        return m_options.memory_budget - m_memory_used;
+    }
+
+    // Charges `size` bytes allocated while deserializing against `ArchiveOptions::memory_budget`, throwing once the
+    // budget is exceeded. Used directly by containers that allocate each element separately.
+    void charge_memory(const uint64_t size)
+    {
+        if (m_mode != Mode::deserialize) {
+            return;
+        }
+        if (size > m_options.memory_budget - m_memory_used) {
+            throw std::runtime_error("Memory budget exceeded");
+        }
+        m_memory_used += size;
+    }
+
+    template <class Type>
+        requires(DefaultSerializable<Type> && !std::is_const_v<std::remove_reference_t<Type>>)
+    void archive(Type& value)
+    {
+        DefaultSerializer<Type>()(*this, value);
+    }
+
+    template <class SerializeType, class Type>
+        requires(Serializer<SerializeType, Type> && !std::is_const_v<std::remove_reference_t<Type>>)
+    void archive(Type& value)
+    {
+        SerializeType()(*this, value);
+    }
+
+    // Hands the current buffer window back to the writer (commit) or reader (consume).
+    void sync()
+    {
+        if (m_mode == Mode::serialize) {
+            if (m_writer_table->commit != nullptr) {
+                m_writer_table->commit(m_io, static_cast<size_t>(m_write_cursor - m_write_begin));
+            }
+            m_write_begin = m_write_cursor = m_write_end = nullptr;
+        } else if (m_mode == Mode::deserialize) {
+            if (m_reader_table->consume != nullptr) {
+                m_reader_table->consume(m_io, static_cast<size_t>(m_read_cursor - m_read_begin));
+            }
+            m_read_begin = m_read_cursor = m_read_end = nullptr;
+        }
+    }
+
+    [[nodiscard]] bool serializing() const
+    {
+        return m_mode != Mode::deserialize;
+    }
+
+    [[nodiscard]] bool deserializing() const
+    {
+        return m_mode == Mode::deserialize;
+    }
+
+    // Whether `borrow_span` can be used, which requires deserializing from a contiguous reader.
+    [[nodiscard]] bool can_borrow() const
+    {
+        return m_mode == Mode::deserialize && m_reader_table->contiguous;
+    }
+
+    // Whether `reserve_size` can be used, which requires serializing to a `PatchableWriter` or counting.
+    [[nodiscard]] bool can_reserve_size() const
+    {
+        return m_mode == Mode::count || (m_mode == Mode::serialize && m_writer_table->patch != nullptr);
+    }
+
+    // Whether this is a counting archive, which is also serializing. See `create_for_counting`.
+    [[nodiscard]] bool counting() const
+    {
+        return m_mode == Mode::count;
+    }
+
+    [[nodiscard]] std::endian endian() const
+    {
+        return m_options.endian;
+    }
+
+    [[nodiscard]] const ArchiveOptions& options() const
+    {
+        return m_options;
+    }
+
+    [[nodiscard]] std::pmr::memory_resource* memory_resource() const
+    {
+        return m_options.memory_resource != nullptr ? m_options.memory_resource : std::pmr::get_default_resource();
+    }
+
+    // Default constructs a value to deserialize into with uses-allocator construction, so that values with a
+    // polymorphic allocator, such as `std::pmr::string`, allocate from `memory_resource`.
+    template <class Type>
+    [[nodiscard]] Type make_value() const
+    {
+        return std::make_obj_using_allocator<Type>(std::pmr::polymorphic_allocator<>(memory_resource()));
+    }
+
+    // Number of bytes archived by a counting archive.
+    [[nodiscard]] size_t counted_size() const
+    {
+        return m_counted_size;
+    }
+
+    // Adds `size` bytes to a counting archive without archiving them, for serializers that already know the size of
+    // their output.
+    void count_bytes(const size_t size)
+    {
+        if (m_mode != Mode::count) {
+            throw std::logic_error("Counting bytes is only possible in a counting archive");
+        }
+        m_counted_size += size;
+    }
+
+private:
+    enum class Mode { serialize, deserialize, count };
+
+    static constexpr size_t max_varint_size = 10;
+
+    [[nodiscard]] size_t reserved_size_width() const
+    {
+        return m_options.size_encoding == SizeEncoding::varint ? max_varint_size : sizeof(uint64_t);
+    }
+    static constexpr size_t allocation_chunk_size = 64 * 1024;
+
+    Mode m_mode;
+    ArchiveOptions m_options;
+    void* m_io { };
+    const detail::WriterTable* m_writer_table { };
+    const detail::ReaderTable* m_reader_table { };
+    // Buffered writers and readers expose a window that the archive accesses directly so that archiving a value
+    // only calls into the writer or reader when the window is exhausted.
+    std::byte* m_write_begin { };
+    std::byte* m_write_cursor { };
+    std::byte* m_write_end { };
+    const std::byte* m_read_begin { };
+    const std::byte* m_read_cursor { };
+    const std::byte* m_read_end { };
+    std::unique_ptr<CallbackWriter> m_callback_writer { };
+    std::unique_ptr<CallbackReader> m_callback_reader { };
+    size_t m_counted_size { };
+    uint64_t m_memory_used { };
+    size_t m_min_reference_size { std::numeric_limits<size_t>::max() };
+
+    template <Writer WriterType>
+    explicit Archive(WriterType& writer, const ArchiveOptions& options)
+        : m_mode { Mode::serialize }
+        , m_options { options }
+        , m_io { std::addressof(writer) }
+        , m_writer_table { &detail::writer_table<WriterType> }
+    {
+        if constexpr (ReferencingWriter<WriterType>) {
+            m_min_reference_size = std::max<size_t>(writer.min_reference_size(), 1);
+        }
+    }
+
+    template <Reader ReaderType>
+    explicit Archive(ReaderType& reader, const ArchiveOptions& options)
+        : m_mode { Mode::deserialize }
+        , m_options { options }
+        , m_io { std::addressof(reader) }
+        , m_reader_table { &detail::reader_table<ReaderType> }
+    {
+    }
+
+    explicit Archive(const ArchiveOptions& options)
+        : m_mode { Mode::count }
+        , m_options { options }
+    {
+    }
+
+    void write_bytes(const std::span<const std::byte> bytes)
+    {
+        if (static_cast<size_t>(m_write_end - m_write_cursor) >= bytes.size()) {
+            std::memcpy(m_write_cursor, bytes.data(), bytes.size());
+            m_write_cursor += bytes.size();
+        } else {
+            write_bytes_slow(bytes);
+        }
+    }
+
+    void write_bytes_slow(const std::span<const std::byte> bytes)
+    {
+        if (m_writer_table->prepare != nullptr) {
+            m_writer_table->commit(m_io, static_cast<size_t>(m_write_cursor - m_write_begin));
+            m_write_begin = m_write_cursor = m_write_end = nullptr;
+            const std::span<std::byte> buffer = m_writer_table->prepare(m_io, bytes.size());
+            if (buffer.size() >= bytes.size()) {
+                m_write_begin = buffer.data();
+                m_write_end = buffer.data() + buffer.size();
+                std::memcpy(buffer.data(), bytes.data(), bytes.size());
+                m_write_cursor = buffer.data() + bytes.size();
+                return;
+            }
+        }
+        m_writer_table->write(m_io, bytes);
+    }
+
+    // Swaps elements of `Size` bytes straight into the writer's buffer, or through a small stack buffer for writers
+    // that do not expose one.
+    template <size_t Size>
+    void write_bytes_swapped(std::span<const std::byte> bytes)
+    {
+        std::array<std::byte, 4096 - 4096 % Size> stack_buffer;
+        while (!bytes.empty()) {
+            if (static_cast<size_t>(m_write_end - m_write_cursor) < Size && m_writer_table->prepare != nullptr) {
+                m_writer_table->commit(m_io, static_cast<size_t>(m_write_cursor - m_write_begin));
+                m_write_begin = m_write_cursor = m_write_end = nullptr;
+                const std::span<std::byte> buffer = m_writer_table->prepare(m_io, bytes.size());
+                if (buffer.size() >= Size) {
+                    m_write_begin = m_write_cursor = buffer.data();
+                    m_write_end = buffer.data() + buffer.size();
+                }
+            }
+            const auto available = static_cast<size_t>(m_write_end - m_write_cursor);
+            if (available >= Size) {
+                const size_t count = std::min(bytes.size(), available) / Size;
+                detail::byteswap_copy<Size>(m_write_cursor, bytes.data(), count);
+                m_write_cursor += count * Size;
+                bytes = bytes.subspan(count * Size);
+            } else {
+                const size_t count = std::min(bytes.size(), stack_buffer.size()) / Size;
+                detail::byteswap_copy<Size>(stack_buffer.data(), bytes.data(), count);
+                m_writer_table->write(m_io, std::span(stack_buffer).first(count * Size));
+                bytes = bytes.subspan(count * Size);
+            }
+        }
+    }
+
+    std::span<const std::byte> read_bytes(const size_t size)
+    {
+        if (static_cast<size_t>(m_read_end - m_read_cursor) >= size) {
+            const std::span<const std::byte> bytes { m_read_cursor, size };
+            m_read_cursor += size;
+            return bytes;
+        }
+        return read_bytes_slow(size);
+    }
+
+    std::span<const std::byte> read_bytes_slow(const size_t size)
+    {
+        if (m_reader_table->data != nullptr) {
+            m_reader_table->consume(m_io, static_cast<size_t>(m_read_cursor - m_read_begin));
+            m_read_begin = m_read_cursor = m_read_end = nullptr;
+            const std::span<const std::byte> buffer = m_reader_table->data(m_io, size);
+            if (buffer.size() < size) {
+                throw std::runtime_error("Insufficient data to deserialize");
+            }
+            m_read_begin = buffer.data();
+            m_read_end = buffer.data() + buffer.size();
+            m_read_cursor = buffer.data() + size;
+            return buffer.first(size);
+        }
+        const std::span<const std::byte> source = m_reader_table->read(m_io, size);
+        if (source.size() < size) {
+            throw std::runtime_error("Read callback returned insufficient data");
+        }
+        return source.first(size);
+    }
+
+    // Size of the rest of the input from a contiguous reader, whose `data` returns all of it.
+    size_t remaining_input_size()
+    {
+        if (m_read_cursor == m_read_end) {
+            m_reader_table->consume(m_io, static_cast<size_t>(m_read_cursor - m_read_begin));
+            const std::span<const std::byte> buffer = m_reader_table->data(m_io, 0);
+            m_read_begin = m_read_cursor = buffer.data();
+            m_read_end = buffer.data() + buffer.size();
+        }
+        return static_cast<size_t>(m_read_end - m_read_cursor);
+    }
+
+    void read_bytes_into(std::span<std::byte> dest)
+    {
+        if (static_cast<size_t>(m_read_end - m_read_cursor) >= dest.size()) {
+            std::memcpy(dest.data(), m_read_cursor, dest.size());
+            m_read_cursor += dest.size();
+            return;
+        }
+        if (m_reader_table->data == nullptr) {
+            const std::span<const std::byte> source = read_bytes_slow(dest.size());
+            std::memcpy(dest.data(), source.data(), dest.size());
+            return;
+        }
+        // Copy whatever the reader has buffered so that large spans never require the reader to buffer them whole.
+        while (!dest.empty()) {
+            if (m_read_cursor == m_read_end) {
+                m_reader_table->consume(m_io, static_cast<size_t>(m_read_cursor - m_read_begin));
+                m_read_begin = m_read_cursor = m_read_end = nullptr;
+                const std::span<const std::byte> buffer = m_reader_table->data(m_io, 1);
+                if (buffer.empty()) {
+                    throw std::runtime_error("Insufficient data to deserialize");
+                }
+                m_read_begin = m_read_cursor = buffer.data();
+                m_read_end = buffer.data() + buffer.size();
+            }
+            const size_t size = std::min(dest.size(), static_cast<size_t>(m_read_end - m_read_cursor));
+            std::memcpy(dest.data(), m_read_cursor, size);
+            m_read_cursor += size;
+            dest = dest.subspan(size);
+        }
+    }
+
+    // Decodes varints of up to 8 bytes from a single load: the first clear high bit marks the end and the 7-bit
+    // groups are packed together with three shift and mask steps.
+    void read_varint_fast(uint64_t& value)
+    {
+        uint64_t word;
+        std::memcpy(&word, m_read_cursor, sizeof(word));
+        if constexpr (std::endian::native == std::endian::big) {
+            auto* bytes = reinterpret_cast<std::byte*>(&word);
+            detail::byteswap_copy<sizeof(word)>(bytes, bytes, 1);
+        }
+        const uint64_t ends = ~word & 0x8080808080808080;
+        if (ends == 0) {
+            read_varint_slow(value);
+            return;
+        }
+        const int bits = std::countr_zero(ends) + 1;
+        m_read_cursor += bits / 8;
+        if (bits < 64) {
+            word &= (uint64_t(1) << bits) - 1;
+        }
+        word &= 0x7f7f7f7f7f7f7f7f;
+        word = ((word & 0x7f007f007f007f00) >> 1) | (word & 0x007f007f007f007f);
+        word = ((word & 0x3fff00003fff0000) >> 2) | (word & 0x00003fff00003fff);
+        word = ((word & 0x0fffffff00000000) >> 4) | (word & 0x000000000fffffff);
+        value = word;
+    }
+
+    void read_varint_slow(uint64_t& value)
+    {
+        uint64_t result = 0;
+        for (size_t i = 0; i < max_varint_size; ++i) {
+            const auto byte = std::to_integer<uint64_t>(read_bytes(1)[0]);
+            if (i == max_varint_size - 1 && byte > 1) {
+                throw std::runtime_error("Varint is too large");
+            }
+            result |= (byte & 0x7f) << (7 * i);
+            if ((byte & 0x80) == 0) {
+                value = result;
+                return;
+            }
+        }
+        throw std::runtime_error("Varint is too large");
+    }
+};
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+struct DefaultSerializer {
+    void operator()(Archive& archive, Type& value) const
+    {
+        if constexpr (ValueSerializable<Type>) {
+            archive.archive_value(value);
+        } else if constexpr (MethodSerializable<Type>) {
+            value.serialize(archive);
+        } else if constexpr (FunctionSerializable<Type>) {
+            serialize(archive, value);
+        }
+    }
+};
+
+namespace detail {
+
+// Integral types that hold numbers, excluding `bool` and the character types.
+template <class Type>
+concept VarintInteger = std::is_integral_v<Type>
+    && !std::same_as<std::remove_cv_t<Type>, bool> && !std::same_as<std::remove_cv_t<Type>, char>
+    && !std::same_as<std::remove_cv_t<Type>, wchar_t> && !std::same_as<std::remove_cv_t<Type>, char8_t>
+    && !std::same_as<std::remove_cv_t<Type>, char16_t> && !std::same_as<std::remove_cv_t<Type>, char32_t>;
+
+}
+
+// Archives an unsigned integer as a LEB128 varint so that small values take fewer bytes.
+template <class Type>
+    requires(detail::VarintInteger<Type> && std::is_unsigned_v<Type>)
+struct VarintSerializer {
+    void operator()(Archive& ar, Type& value) const
+    {
+        if (ar.serializing()) {
+            uint64_t encoded = value;
+            ar.archive_varint(encoded);
+        } else {
+            uint64_t encoded = 0;
+            ar.archive_varint(encoded);
+            if (encoded > std::numeric_limits<Type>::max()) {
+                throw std::runtime_error("Varint is too large");
+            }
+            value = static_cast<Type>(encoded);
+        }
+    }
+};
+
+// Archives a signed integer as a zigzag encoded LEB128 varint so that values close to zero, positive or negative,
+// take fewer bytes.
+template <class Type>
+    requires(detail::VarintInteger<Type> && std::is_signed_v<Type>)
+struct ZigZagSerializer {
+    void operator()(Archive& ar, Type& value) const
+    {
+        if (ar.serializing()) {
+            const auto signed_value = static_cast<int64_t>(value);
+            uint64_t encoded = (static_cast<uint64_t>(signed_value) << 1) ^ static_cast<uint64_t>(signed_value >> 63);
+            ar.archive_varint(encoded);
+        } else {
+            uint64_t encoded = 0;
+            ar.archive_varint(encoded);
+            const auto decoded = static_cast<int64_t>((encoded >> 1) ^ (~(encoded & 1) + 1));
+            if (decoded < std::numeric_limits<Type>::min() || decoded > std::numeric_limits<Type>::max()) {
+                throw std::runtime_error("Varint is too large");
+            }
+            value = static_cast<Type>(decoded);
+        }
+    }
+};
+
+struct VectorOptions {
+    // Compute the exact serialized size with a counting pass first so that `serialize_to_vector` allocates its output
+    // once.
+    bool presize = false;
+};
+
+class VectorWriter {
+public:
+    // Bytes are appended to the end of `vector`. While writing, the vector may be resized past the written bytes so
+    // that its storage can be handed out directly; it is trimmed back to the written size on destruction.
+    explicit VectorWriter(std::vector<std::byte>& vector)
+        : m_vector { vector }
+        , m_size { vector.size() }
+    {
+    }
+
+    VectorWriter(const VectorWriter&) = delete;
+    VectorWriter& operator=(const VectorWriter&) = delete;
+
+    ~VectorWriter()
+    {
+        m_vector.resize(m_size);
+    }
+
+    void write(const std::span<const std::byte> bytes)
+    {
+        const std::span<std::byte> buffer = prepare(bytes.size());
+        std::memcpy(buffer.data(), bytes.data(), bytes.size());
+        commit(bytes.size());
+    }
+
+    std::span<std::byte> prepare(const size_t size)
+    {
+        if (m_vector.size() - m_size < size) {
+            if (m_vector.capacity() - m_size < size) {
+                m_vector.reserve(std::max({ m_size + size, m_vector.capacity() * 2, min_capacity }));
+            }
+            m_vector.resize(m_vector.capacity());
+        }
+        return std::span<std::byte>(m_vector).subspan(m_size);
+    }
+
+    void commit(const size_t size)
+    {
+        m_size += size;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] uint64_t position() const
+    {
+        return m_size;
+    }
+
+    void patch(const uint64_t position, const std::span<const std::byte> bytes)
+    {
+        std::memcpy(m_vector.data() + position, bytes.data(), bytes.size());
+    }
+
+private:
+    static constexpr size_t min_capacity = 64;
+
+    std::vector<std::byte>& m_vector;
+    size_t m_size;
+};
+
+// Writes into a fixed span of memory without allocating. Writing past the end of the span is not an error: the
+// writer stops writing, marks itself as overflowed and keeps counting the bytes that would have been written, so that
+// `size` then reports the span size needed.
+class SpanWriter {
+public:
+    explicit SpanWriter(const std::span<std::byte> buffer)
+        : m_buffer { buffer }
+    {
+    }
+
+    void write(const std::span<const std::byte> bytes)
+    {
+        if (!m_overflowed && m_buffer.size() - m_size >= bytes.size()) {
+            if (!bytes.empty()) {
+                std::memcpy(m_buffer.data() + m_size, bytes.data(), bytes.size());
+            }
+        } else {
+            m_overflowed = true;
+        }
+        m_size += bytes.size();
+    }
+
+    std::span<std::byte> prepare(size_t)
+    {
+        if (m_overflowed) {
+            return { };
+        }
+        return m_buffer.subspan(m_size);
+    }
+
+    void commit(const size_t size)
+    {
+        m_size += size;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool overflowed() const
+    {
+        return m_overflowed;
+    }
+
+    [[nodiscard]] uint64_t position() const
+    {
+        return m_size;
+    }
+
+    // Bytes past the end of the span were never written, so patching them is skipped.
+    void patch(const uint64_t position, const std::span<const std::byte> bytes)
+    {
+        if (position <= m_buffer.size() && m_buffer.size() - position >= bytes.size()) {
+            std::memcpy(m_buffer.data() + position, bytes.data(), bytes.size());
+        }
+    }
+
+private:
+    std::span<std::byte> m_buffer;
+    size_t m_size { };
+    bool m_overflowed { false };
+};
 
-class Archive;
+class SpanReader {
+public:
+    static constexpr bool contiguous = true;
 
-template <class Type>
-concept IntegerSerializable
-    = std::is_integral_v<Type> || (std::is_enum_v<Type> && std::is_integral_v<std::underlying_type_t<Type>>);
+    explicit SpanReader(const std::span<const std::byte> bytes)
+        : m_bytes { bytes }
+    {
+    }
 
-template <class Type>
-concept FloatSerializable = std::is_floating_point_v<Type> && std::numeric_limits<Type>::is_iec559;
+    std::span<const std::byte> read(const size_t size)
+    {
+        if (m_bytes.size() < size) {
+            throw std::runtime_error("Insufficient data to deserialize");
+        }
+        const std::span<const std::byte> bytes = m_bytes.first(size);
+        m_bytes = m_bytes.subspan(size);
+        return bytes;
+    }
 
-template <class Type>
-concept ValueSerializable = IntegerSerializable<Type> || FloatSerializable<Type>;
+    [[nodiscard]] std::span<const std::byte> data(size_t) const
+    {
+        return m_bytes;
+    }
 
-template <class Type>
-concept MethodSerializable = requires(Type type, Archive& archive) { type.serialize(archive); };
+    void consume(const size_t size)
+    {
+        m_bytes = m_bytes.subspan(size);
+    }
 
-template <class Type>
-concept FunctionSerializable = requires(Type type, Archive& archive) { serialize(archive, type); };
+    [[nodiscard]] std::span<const std::byte> remaining() const
+    {
+        return m_bytes;
+    }
 
-template <class Type>
-concept ObjectSerializable = MethodSerializable<Type> || FunctionSerializable<Type>;
+private:
+    std::span<const std::byte> m_bytes;
+};
 
-template <class Type>
-concept DefaultSerializable = ValueSerializable<Type> || ObjectSerializable<Type>;
+namespace detail {
 
-template <class SerializeType, class Type>
-concept Serializer = requires(SerializeType serialize, Archive& archive, Type& value) {
-    { serialize.operator()(archive, value) } -> std::same_as<void>;
-} && std::is_default_constructible_v<SerializeType>;
+// Direct I/O transfers must start at, and be a multiple of, the device's logical block size, which is at most this on
+// common hardware. The buffers transferred must be aligned to it as well.
+constexpr size_t direct_io_alignment = 4096;
 
-using WriteCallback = std::function<void(std::span<const std::byte>)>;
-using ReadCallback = std::function<std::span<const std::byte>(size_t)>;
+constexpr size_t align_to_direct_io(const size_t size)
+{
+    return (size + direct_io_alignment - 1) / direct_io_alignment * direct_io_alignment;
+}
 
-template <class Type>
-    requires(DefaultSerializable<Type>)
-struct DefaultSerializer;
+struct AlignedDeleter {
+    void operator()(std::byte* const pointer) const
+    {
+        ::operator delete[](pointer, std::align_val_t { direct_io_alignment });
+    }
+};
 
-class Archive {
+using AlignedBuffer = std::unique_ptr<std::byte[], AlignedDeleter>;
+
+inline AlignedBuffer make_aligned_buffer(const size_t size)
+{
+    return AlignedBuffer { static_cast<std::byte*>(::operator new[](size, std::align_val_t { direct_io_alignment })) };
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// Opens the file bypassing the page cache if `direct_io` is requested and supported, falling back to a regular open
+// for file systems that reject it. `direct` is set to whether the returned file transfers directly.
+inline int open_file(const std::filesystem::path& path, int flags, const bool direct_io, bool& direct)
+{
+    direct = false;
+    flags |= O_CLOEXEC;
+#if defined(O_DIRECT)
+    if (direct_io) {
+        const int file = ::open(path.c_str(), flags | O_DIRECT, 0666);
+        if (file != -1 || errno != EINVAL) {
+            direct = file != -1;
+            return file;
+        }
+    }
+#endif
+    const int file = ::open(path.c_str(), flags, 0666);
+#if defined(__APPLE__)
+    if (direct_io && file != -1) {
+        ::fcntl(file, F_NOCACHE, 1);
+    }
+#endif
+    return file;
+}
+#endif
+
+}
+
+struct FileWriterOptions {
+    // Writes are collected in a buffer of this size and written to the file when it fills. Writes at least as large
+    // as the buffer bypass it.
+    size_t buffer_size = 4 * 1024 * 1024;
+    // Writes bypass the operating system's page cache so that writing a large file does not evict other cached data or
+    // wait on write-back. The buffer size is rounded up to a multiple of 4 KiB and all writes go through it. Where
+    // direct I/O is unsupported, such as on file systems without it, the file is written normally.
+    bool direct_io = false;
+    // When non-zero and supported, disk space for this many bytes is reserved up front so that large files are laid
+    // out contiguously. It does not change the size of the file.
+    uint64_t preallocate_size = 0;
+};
+
+class FileWriter {
 public:
-    static Archive create_for_serializing(WriteCallback write_callback, const std::endian endian)
+    explicit FileWriter(const std::filesystem::path& path, const FileWriterOptions& options = { })
+        : m_path { path }
+        , m_buffer_size { options.direct_io
+                              ? std::max(detail::align_to_direct_io(options.buffer_size), detail::direct_io_alignment)
+                              : options.buffer_size }
+        , m_buffer { detail::make_aligned_buffer(m_buffer_size) }
     {
-        return Archive(std::move(write_callback), endian);
+#if defined(__unix__) || defined(__APPLE__)
+        // Patching with direct I/O reads back whole blocks.
+        const int access = options.direct_io ? O_RDWR : O_WRONLY;
+        m_file = detail::open_file(path, access | O_CREAT | O_TRUNC, options.direct_io, m_direct);
+        if (m_file == -1) {
+            throw std::runtime_error("Unable to open file: " + m_path.string());
+        }
+#if defined(__linux__)
+        if (options.preallocate_size > 0) {
+            // Only an optimization, so failures such as the file system not supporting it are ignored.
+            ::fallocate(m_file, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(options.preallocate_size));
+        }
+#endif
+#else
+        m_file.open(path, std::ios::binary);
+        if (!m_file.is_open()) {
+            throw std::runtime_error("Unable to open file: " + m_path.string());
+        }
+#endif
     }
 
-    static Archive create_for_deserializing(ReadCallback read_callback, const std::endian endian)
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    // Buffered bytes are written on destruction but errors can only be observed by calling `flush` beforehand.
+    ~FileWriter()
     {
-        return Archive(std::move(read_callback), endian);
+        try {
+            flush();
+        } catch (...) {
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        ::close(m_file);
+#endif
     }
 
-    template <class Value>
-        requires(ValueSerializable<Value>)
-    void archive_value(Value& value)
+    void write(std::span<const std::byte> bytes)
     {
-        if (m_mode == Mode::serialize) {
-            std::span<const std::byte> bytes = std::as_bytes(std::span<const Value>(&value, 1));
-            if (m_endian == std::endian::native) {
-                m_write_callback(bytes);
-            } else {
-                std::array<std::byte, sizeof(Value)> reversed;
-                std::ranges::copy(bytes | std::views::reverse, reversed.begin());
-                m_write_callback(reversed);
+        if (m_direct) {
+            while (!bytes.empty()) {
+                if (m_size == m_buffer_size) {
+                    write_blocks();
+                }
+                const size_t size = std::min(bytes.size(), m_buffer_size - m_size);
+                std::memcpy(m_buffer.get() + m_size, bytes.data(), size);
+                m_size += size;
+                bytes = bytes.subspan(size);
             }
-        } else {
-            std::span<const std::byte> source = m_read_callback(sizeof(Value));
-            if (source.size() < sizeof(Value)) {
-                throw std::runtime_error("Read callback returned insufficient data");
+            return;
+        }
+        if (m_buffer_size - m_size < bytes.size()) {
+            flush();
+            if (bytes.size() >= m_buffer_size) {
+                write_file(bytes);
+                return;
             }
-            std::span<std::byte> dest = std::as_writable_bytes(std::span<Value>(&value, 1));
-            if (m_endian == std::endian::native) {
-                std::ranges::copy(source, dest.begin());
+        }
+        std::memcpy(m_buffer.get() + m_size, bytes.data(), bytes.size());
+        m_size += bytes.size();
+    }
+
+    std::span<std::byte> prepare(const size_t size)
+    {
+        if (m_buffer_size - m_size < size) {
+            if (m_direct) {
+                write_blocks();
             } else {
-                std::ranges::copy(source | std::views::reverse, dest.begin());
+                flush();
             }
         }
+        return { m_buffer.get() + m_size, m_buffer_size - m_size };
     }
 
-    template <class Type>
-        requires(DefaultSerializable<Type> && !std::is_const_v<std::remove_reference_t<Type>>)
-    void archive(Type& value)
+    void commit(const size_t size)
     {
-        DefaultSerializer<Type>()(*this, value);
+        m_size += size;
     }
 
-    template <class SerializeType, class Type>
-        requires(Serializer<SerializeType, Type> && !std::is_const_v<std::remove_reference_t<Type>>)
-    void archive(Type& value)
+    void flush()
     {
-        SerializeType()(*this, value);
+        if (m_direct) {
+            flush_direct();
+            return;
+        }
+        if (m_size > 0) {
+            write_file({ m_buffer.get(), std::exchange(m_size, 0) });
+        }
+#if !(defined(__unix__) || defined(__APPLE__))
+        m_file.flush();
+        if (m_file.bad()) {
+            throw std::runtime_error("Error writing to file: " + m_path.string());
+        }
+#endif
     }
 
-    [[nodiscard]] bool serializing() const
+    // Flushes and then waits for the file's data to reach the storage device so that it survives a crash. Without
+    // POSIX this only flushes.
+    void sync()
     {
-        return m_mode == Mode::serialize;
+        flush();
+#if defined(__unix__) || defined(__APPLE__)
+        if (::fsync(m_file) == -1) {
+            throw std::runtime_error("Error syncing file: " + m_path.string());
+        }
+#endif
     }
 
-    [[nodiscard]] bool deserializing() const
+    [[nodiscard]] uint64_t position() const
     {
-        return m_mode == Mode::deserialize;
+        return m_offset + m_size;
+    }
+
+    // Bytes still in the buffer are patched in place and bytes already written are overwritten in the file.
+    void patch(uint64_t position, std::span<const std::byte> bytes)
+    {
+        if (position < m_offset) {
+            const auto size = static_cast<size_t>(std::min<uint64_t>(bytes.size(), m_offset - position));
+            patch_file(position, bytes.first(size));
+            position += size;
+            bytes = bytes.subspan(size);
+        }
+        if (!bytes.empty()) {
+            std::memcpy(m_buffer.get() + (position - m_offset), bytes.data(), bytes.size());
+        }
     }
 
 private:
-    enum class Mode { serialize, deserialize };
+    std::filesystem::path m_path;
+    size_t m_buffer_size;
+    detail::AlignedBuffer m_buffer;
+    size_t m_size { };
+    bool m_direct { false };
+    // The file offset of the start of the buffer, which is always aligned with direct I/O.
+    uint64_t m_offset { };
+#if defined(__unix__) || defined(__APPLE__)
+    int m_file { -1 };
+#else
+    std::ofstream m_file;
+#endif
 
-    Mode m_mode;
-    std::endian m_endian;
-    WriteCallback m_write_callback { };
-    ReadCallback m_read_callback { };
+    void write_file(std::span<const std::byte> bytes)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        while (!bytes.empty()) {
+            const ssize_t written = ::write(m_file, bytes.data(), bytes.size());
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Error writing to file: " + m_path.string());
+            }
+            bytes = bytes.subspan(static_cast<size_t>(written));
+            m_offset += static_cast<uint64_t>(written);
+        }
+#else
+        m_file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (m_file.bad()) {
+            throw std::runtime_error("Error writing to file: " + m_path.string());
+        }
+        m_offset += bytes.size();
+#endif
+    }
 
-    explicit Archive(WriteCallback write_callback, const std::endian endian)
-        : m_mode { Mode::serialize }
-        , m_endian { endian }
-        , m_write_callback { std::move(write_callback) }
+#if defined(__unix__) || defined(__APPLE__)
+    void write_file_at(std::span<const std::byte> bytes, uint64_t offset)
     {
+        while (!bytes.empty()) {
+            const ssize_t written = ::pwrite(m_file, bytes.data(), bytes.size(), static_cast<off_t>(offset));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Error writing to file: " + m_path.string());
+            }
+            bytes = bytes.subspan(static_cast<size_t>(written));
+            offset += static_cast<uint64_t>(written);
+        }
     }
 
-    explicit Archive(ReadCallback read_callback, const std::endian endian)
-        : m_mode { Mode::deserialize }
-        , m_endian { endian }
-        , m_read_callback { std::move(read_callback) }
+    // Writes the whole blocks in the buffer and moves the remaining bytes to its front.
+    void write_blocks()
+    {
+        const size_t size = m_size / detail::direct_io_alignment * detail::direct_io_alignment;
+        if (size == 0) {
+            return;
+        }
+        write_file_at({ m_buffer.get(), size }, m_offset);
+        m_offset += size;
+        m_size -= size;
+        std::memmove(m_buffer.get(), m_buffer.get() + size, m_size);
+    }
+
+    // A partial last block can only be written padded to a whole block, so it is written with zeros after it and the
+    // file is truncated back to its length. The partial block stays buffered and is rewritten once more bytes follow.
+    void flush_direct()
+    {
+        write_blocks();
+        if (m_size == 0) {
+            return;
+        }
+        const size_t padded_size = detail::align_to_direct_io(m_size);
+        std::memset(m_buffer.get() + m_size, 0, padded_size - m_size);
+        write_file_at({ m_buffer.get(), padded_size }, m_offset);
+        if (::ftruncate(m_file, static_cast<off_t>(m_offset + m_size)) == -1) {
+            throw std::runtime_error("Error writing to file: " + m_path.string());
+        }
+    }
+    // Direct I/O can only write whole blocks, so the blocks holding the bytes are read, patched and written back.
+    // Bytes before the buffer are always in whole blocks that were already written.
+    void patch_file(const uint64_t position, const std::span<const std::byte> bytes)
+    {
+        if (!m_direct) {
+            write_file_at(bytes, position);
+            return;
+        }
+        constexpr uint64_t alignment = detail::direct_io_alignment;
+        const uint64_t begin = position / alignment * alignment;
+        const auto size = static_cast<size_t>(detail::align_to_direct_io(position + bytes.size() - begin));
+        detail::AlignedBuffer blocks = detail::make_aligned_buffer(size);
+        for (size_t read = 0; read < size;) {
+            const ssize_t result = ::pread(m_file, blocks.get() + read, size - read, static_cast<off_t>(begin + read));
+            if (result <= 0) {
+                if (result < 0 && errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Error writing to file: " + m_path.string());
+            }
+            read += static_cast<size_t>(result);
+        }
+        std::memcpy(blocks.get() + (position - begin), bytes.data(), bytes.size());
+        write_file_at({ blocks.get(), size }, begin);
+    }
+#else
+    void write_blocks()
+    {
+    }
+
+    void flush_direct()
     {
     }
+
+    void patch_file(const uint64_t position, const std::span<const std::byte> bytes)
+    {
+        m_file.seekp(static_cast<std::streamoff>(position));
+        m_file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        m_file.seekp(0, std::ios::end);
+        if (m_file.bad()) {
+            throw std::runtime_error("Error writing to file: " + m_path.string());
+        }
+    }
+#endif
 };
 
-template <class Type>
-    requires(DefaultSerializable<Type>)
-struct DefaultSerializer {
-    void operator()(Archive& archive, Type& value) const
+struct FileReaderOptions {
+    // The file is read ahead in chunks of this size. Requests larger than the buffer are served by a one-off
+    // allocation.
+    size_t buffer_size = 4 * 1024 * 1024;
+    // Reads bypass the operating system's page cache, see `FileWriterOptions::direct_io`. The buffer size is rounded
+    // up to a multiple of 4 KiB.
+    bool direct_io = false;
+};
+
+class FileReader {
+public:
+    explicit FileReader(const std::filesystem::path& path, const FileReaderOptions& options = { })
+        : m_path { path }
+        , m_buffer_size { options.direct_io
+                              ? std::max(detail::align_to_direct_io(options.buffer_size), detail::direct_io_alignment)
+                              : std::max<size_t>(options.buffer_size, 1) }
+        , m_buffer { detail::make_aligned_buffer(m_buffer_size) }
+        , m_capacity { m_buffer_size }
     {
-        if constexpr (ValueSerializable<Type>) {
-            archive.archive_value(value);
-        } else if constexpr (MethodSerializable<Type>) {
-            value.serialize(archive);
-        } else if constexpr (FunctionSerializable<Type>) {
-            serialize(archive, value);
+#if defined(__unix__) || defined(__APPLE__)
+        m_file = detail::open_file(path, O_RDONLY, options.direct_io, m_direct);
+        if (m_file == -1) {
+            throw std::runtime_error("Unable to open file: " + m_path.string());
+        }
+#if defined(__linux__)
+        ::posix_fadvise(m_file, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#else
+        m_file.open(path, std::ios::binary);
+        if (!m_file.is_open()) {
+            throw std::runtime_error("Unable to open file: " + m_path.string());
+        }
+#endif
+    }
+
+    FileReader(const FileReader&) = delete;
+    FileReader& operator=(const FileReader&) = delete;
+
+    ~FileReader()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        ::close(m_file);
+#endif
+    }
+
+    std::span<const std::byte> read(const size_t size)
+    {
+        const std::span<const std::byte> bytes = data(size);
+        const size_t read_size = std::min(size, bytes.size());
+        consume(read_size);
+        return bytes.first(read_size);
+    }
+
+    std::span<const std::byte> data(const size_t size)
+    {
+        if (m_end - m_begin < size) {
+            fill(size);
+        }
+        return { m_buffer.get() + m_begin, m_end - m_begin };
+    }
+
+    void consume(const size_t size)
+    {
+        m_begin += size;
+    }
+
+private:
+    std::filesystem::path m_path;
+    size_t m_buffer_size;
+    detail::AlignedBuffer m_buffer;
+    size_t m_capacity;
+    size_t m_begin { };
+    size_t m_end { };
+    bool m_eof { false };
+    bool m_direct { false };
+#if defined(__unix__) || defined(__APPLE__)
+    int m_file { -1 };
+#else
+    std::ifstream m_file;
+#endif
+
+    // Moves the unconsumed bytes to the front of the buffer and reads until at least `size` bytes are buffered or
+    // the end of the file is reached. With direct I/O, reads must fill whole blocks of the buffer, so the unconsumed
+    // bytes are placed just before a block boundary instead.
+    void fill(const size_t size)
+    {
+        const size_t remaining = m_end - m_begin;
+        const size_t padding = m_direct ? detail::align_to_direct_io(remaining) - remaining : 0;
+        const size_t required = padding + std::max(size, remaining);
+        const size_t capacity = std::max(m_direct ? detail::align_to_direct_io(required) : required, m_buffer_size);
+        if (capacity != m_capacity) {
+            detail::AlignedBuffer buffer = detail::make_aligned_buffer(capacity);
+            std::memcpy(buffer.get() + padding, m_buffer.get() + m_begin, remaining);
+            m_buffer = std::move(buffer);
+            m_capacity = capacity;
+        } else if (m_begin != padding) {
+            std::memmove(m_buffer.get() + padding, m_buffer.get() + m_begin, remaining);
+        }
+        m_begin = padding;
+        m_end = padding + remaining;
+        while (m_end - m_begin < size && !m_eof) {
+            size_t read_size = m_capacity - m_end;
+            if (m_direct) {
+                read_size -= read_size % detail::direct_io_alignment;
+            }
+            const size_t bytes_read = read_file({ m_buffer.get() + m_end, read_size });
+            // A direct read only returns a partial block at the end of the file.
+            m_eof = bytes_read == 0 || (m_direct && bytes_read % detail::direct_io_alignment != 0);
+            m_end += bytes_read;
+        }
+    }
+
+    size_t read_file(const std::span<std::byte> buffer)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        while (true) {
+            const ssize_t bytes_read = ::read(m_file, buffer.data(), buffer.size());
+            if (bytes_read >= 0) {
+                return static_cast<size_t>(bytes_read);
+            }
+            if (errno != EINTR) {
+                throw std::runtime_error("Error reading file: " + m_path.string());
+            }
         }
+#else
+        m_file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (m_file.bad()) {
+            throw std::runtime_error("Error reading file: " + m_path.string());
+        }
+        return static_cast<size_t>(m_file.gcount());
+#endif
     }
 };
 
+template <class TypeSerializer, class Type, class WriterType>
+    requires(Serializer<TypeSerializer, Type> && Writer<WriterType>)
+void serialize_using_writer(Type& value, WriterType& writer, const ArchiveOptions& archive_options = { })
+{
+    auto ar = Archive::create_for_serializing(writer, archive_options);
+    ar.template archive<TypeSerializer>(value);
+    ar.sync();
+}
+
+template <class Type, class WriterType>
+    requires(DefaultSerializable<Type> && Writer<WriterType>)
+void serialize_using_writer(Type& value, WriterType& writer, const ArchiveOptions& archive_options = { })
+{
+    serialize_using_writer<DefaultSerializer<Type>>(value, writer, archive_options);
+}
+
+template <class TypeSerializer, class Type, class ReaderType>
+    requires(Serializer<TypeSerializer, Type> && Reader<ReaderType>)
+void deserialize_using_reader(Type& value, ReaderType& reader, const ArchiveOptions& archive_options = { })
+{
+    auto ar = Archive::create_for_deserializing(reader, archive_options);
+    ar.template archive<TypeSerializer>(value);
+    ar.sync();
+}
+
+template <class Type, class ReaderType>
+    requires(DefaultSerializable<Type> && Reader<ReaderType>)
+void deserialize_using_reader(Type& value, ReaderType& reader, const ArchiveOptions& archive_options = { })
+{
+    deserialize_using_reader<DefaultSerializer<Type>>(value, reader, archive_options);
+}
+
 template <class TypeSerializer, class Type>
     requires(Serializer<TypeSerializer, Type>)
-void serialize_using_callback(Type& value, WriteCallback write_callback, const std::endian endian = std::endian::little)
+void serialize_using_callback(Type& value, WriteCallback write_callback, const ArchiveOptions& archive_options = { })
 {
-    auto ar = Archive::create_for_serializing(std::move(write_callback), endian);
-    ar.archive<TypeSerializer>(value);
+    CallbackWriter writer { std::move(write_callback) };
+    serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+}
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+void serialize_using_callback(Type& value, WriteCallback write_callback, const ArchiveOptions& archive_options = { })
+{
+    serialize_using_callback<DefaultSerializer<Type>>(value, std::move(write_callback), archive_options);
+}
+
+template <class TypeSerializer, class Type>
+    requires(Serializer<TypeSerializer, Type>)
+void deserialize_using_callback(Type& value, ReadCallback read_callback, const ArchiveOptions& archive_options = { })
+{
+    CallbackReader reader { std::move(read_callback) };
+    deserialize_using_reader<TypeSerializer>(value, reader, archive_options);
 }
 
 template <class Type>
     requires(DefaultSerializable<Type>)
-void serialize_using_callback(Type& value, WriteCallback write_callback, const std::endian endian = std::endian::little)
+void deserialize_using_callback(Type& value, ReadCallback read_callback, const ArchiveOptions& archive_options = { })
 {
-    serialize_using_callback<DefaultSerializer<Type>>(value, std::move(write_callback), endian);
+    deserialize_using_callback<DefaultSerializer<Type>>(value, std::move(read_callback), archive_options);
 }
 
 template <class TypeSerializer, class Type>
     requires(Serializer<TypeSerializer, Type>)
-void deserialize_using_callback(Type& value, ReadCallback read_callback, const std::endian endian = std::endian::little)
+size_t serialized_size(Type& value, const ArchiveOptions& archive_options = { })
 {
-    auto ar = Archive::create_for_deserializing(std::move(read_callback), endian);
+    auto ar = Archive::create_for_counting(archive_options);
     ar.archive<TypeSerializer>(value);
+    return ar.counted_size();
 }
 
 template <class Type>
     requires(DefaultSerializable<Type>)
-void deserialize_using_callback(Type& value, ReadCallback read_callback, const std::endian endian = std::endian::little)
+size_t serialized_size(Type& value, const ArchiveOptions& archive_options = { })
 {
-    deserialize_using_callback<DefaultSerializer<Type>>(value, std::move(read_callback), endian);
+    return serialized_size<DefaultSerializer<Type>>(value, archive_options);
 }
 
 template <class TypeSerializer, class Type>
     requires(Serializer<TypeSerializer, Type>)
-std::vector<std::byte> serialize_to_vector(Type& value, std::endian endian = std::endian::little)
+std::vector<std::byte> serialize_to_vector(
+    Type& value, const ArchiveOptions& archive_options = { }, const VectorOptions& options = { })
 {
     std::vector<std::byte> result;
-    auto ar = Archive::create_for_serializing(
-        [&result](std::span<const std::byte> bytes) { result.insert(result.end(), bytes.begin(), bytes.end()); },
-        endian);
-    ar.template archive<TypeSerializer>(value);
+    if (options.presize) {
+        result.reserve(serialized_size<TypeSerializer>(value, archive_options));
+    }
+    {
+        VectorWriter writer { result };
+        serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+    }
     return result;
 }
 
 template <class Type>
     requires(DefaultSerializable<Type>)
-std::vector<std::byte> serialize_to_vector(Type& value, std::endian endian = std::endian::little)
+std::vector<std::byte> serialize_to_vector(
+    Type& value, const ArchiveOptions& archive_options = { }, const VectorOptions& options = { })
+{
+    return serialize_to_vector<DefaultSerializer<Type>>(value, archive_options, options);
+}
+
+// Serialized bytes stored inline rather than on the heap. See `serialize_to_array`.
+template <size_t Capacity>
+class FixedBuffer {
+public:
+    // User-provided so that value-initialization, such as by `std::optional`, does not zero the storage.
+    FixedBuffer() { }
+
+    // Returns nothing if `value` does not fit.
+    template <class TypeSerializer, class Type>
+        requires(Serializer<TypeSerializer, Type>)
+    static std::optional<FixedBuffer> create(Type& value, const ArchiveOptions& archive_options)
+    {
+        std::optional<FixedBuffer> result { std::in_place };
+        SpanWriter writer { result->m_data };
+        serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+        if (writer.overflowed()) {
+            result.reset();
+        } else {
+            result->m_size = writer.size();
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::span<const std::byte> bytes() const
+    {
+        return std::span(m_data).first(m_size);
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] static constexpr size_t capacity()
+    {
+        return Capacity;
+    }
+
+private:
+    std::array<std::byte, Capacity> m_data;
+    size_t m_size { };
+};
+
+// Serializes into `buffer` without allocating, returning the number of bytes written or nothing if `value` does not
+// fit, in which case the contents of `buffer` are unspecified. Use `SpanWriter` directly to also get the size needed.
+template <class TypeSerializer, class Type>
+    requires(Serializer<TypeSerializer, Type>)
+std::optional<size_t> serialize_into(
+    const std::span<std::byte> buffer, Type& value, const ArchiveOptions& archive_options = { })
+{
+    SpanWriter writer { buffer };
+    serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+    if (writer.overflowed()) {
+        return std::nullopt;
+    }
+    return writer.size();
+}
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+std::optional<size_t> serialize_into(
+    const std::span<std::byte> buffer, Type& value, const ArchiveOptions& archive_options = { })
+{
+    return serialize_into<DefaultSerializer<Type>>(buffer, value, archive_options);
+}
+
+// Serializes small values into a buffer of `Capacity` bytes returned by value, such as onto the stack, instead of
+// `serialize_to_vector`. Returns nothing if `value` does not fit.
+template <size_t Capacity, class TypeSerializer, class Type>
+    requires(Serializer<TypeSerializer, Type>)
+std::optional<FixedBuffer<Capacity>> serialize_to_array(Type& value, const ArchiveOptions& archive_options = { })
+{
+    return FixedBuffer<Capacity>::template create<TypeSerializer>(value, archive_options);
+}
+
+template <size_t Capacity, class Type>
+    requires(DefaultSerializable<Type>)
+std::optional<FixedBuffer<Capacity>> serialize_to_array(Type& value, const ArchiveOptions& archive_options = { })
 {
-    return serialize_to_vector<DefaultSerializer<Type>>(value, endian);
+    return serialize_to_array<Capacity, DefaultSerializer<Type>>(value, archive_options);
 }
 
 template <class TypeSerializer, class Type>
     requires(Serializer<TypeSerializer, Type>)
-void deserialize_from_span(std::span<const std::byte> bytes, Type& value, std::endian endian = std::endian::little)
+void deserialize_from_span(std::span<const std::byte> bytes, Type& value, const ArchiveOptions& archive_options = { })
 {
-    auto ar = Archive::create_for_deserializing(
-        [&bytes](const size_t size) {
-            if (bytes.size() < size) {
-                throw std::runtime_error("Insufficient data to deserialize");
-            }
-            std::span<const std::byte> subspan = bytes.subspan(0, size);
-            bytes = bytes.subspan(size, bytes.size() - size);
-            return subspan;
-        },
-        endian);
-    ar.template archive<TypeSerializer>(value);
+    SpanReader reader { bytes };
+    deserialize_using_reader<TypeSerializer>(value, reader, archive_options);
 }
 
 template <class Type>
     requires(DefaultSerializable<Type>)
-void deserialize_from_span(std::span<const std::byte> bytes, Type& value, std::endian endian = std::endian::little)
+void deserialize_from_span(std::span<const std::byte> bytes, Type& value, const ArchiveOptions& archive_options = { })
 {
-    deserialize_from_span<DefaultSerializer<Type>>(bytes, value, endian);
+    deserialize_from_span<DefaultSerializer<Type>>(bytes, value, archive_options);
 }
 
 template <class TypeSerializer, class Type>
     requires(Serializer<TypeSerializer, Type>)
-void serialize_to_file(const std::filesystem::path& path, Type& value, std::endian endian = std::endian::little)
+void serialize_to_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const FileWriterOptions& options = { })
 {
-    std::ofstream file { path, std::ios::binary };
-    if (!file.is_open()) {
-        throw std::runtime_error("Unable to open file: " + path.string());
-    }
-    auto ar = Archive::create_for_serializing(
-        [&path, &file](const std::span<const std::byte> bytes) {
-            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
-            if (file.bad()) {
-                throw std::runtime_error("Error writing to file: " + path.string());
-            }
-        },
-        endian);
-    ar.template archive<TypeSerializer>(value);
+    FileWriter writer { path, options };
+    serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+    writer.flush();
 }
 
 template <class Type>
     requires(DefaultSerializable<Type>)
-void serialize_to_file(const std::filesystem::path& path, Type& value, std::endian endian = std::endian::little)
+void serialize_to_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const FileWriterOptions& options = { })
 {
-    serialize_to_file<DefaultSerializer<Type>>(path, value, endian);
+    serialize_to_file<DefaultSerializer<Type>>(path, value, archive_options, options);
 }
 
 template <class TypeSerializer, class Type>
     requires(Serializer<TypeSerializer, Type>)
-void deserialize_from_file(const std::filesystem::path& path, Type& value, std::endian endian = std::endian::little)
+void deserialize_from_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const FileReaderOptions& options = { })
 {
-    std::ifstream file { path, std::ios::binary };
-    if (!file.is_open()) {
-        throw std::runtime_error("Unable to open file: " + path.string());
-    }
-    std::vector<std::byte> buffer;
-    auto ar = Archive::create_for_deserializing(
-        [&path, &file, &buffer](const size_t size) {
-            if (buffer.size() < size) {
-                buffer.resize(size);
-            }
-            file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size));
-            if (file.bad()) {
-                throw std::runtime_error("Error reading file: " + path.string());
-            }
-            const std::streamsize bytes_read = file.gcount();
-            return std::span<const std::byte>(buffer.data(), bytes_read);
-        },
-        endian);
-    ar.template archive<TypeSerializer>(value);
+    FileReader reader { path, options };
+    deserialize_using_reader<TypeSerializer>(value, reader, archive_options);
 }
 
 template <class Type>
     requires(DefaultSerializable<Type>)
-void deserialize_from_file(const std::filesystem::path& path, Type& value, std::endian endian = std::endian::little)
+void deserialize_from_file(
+    const std::filesystem::path& path,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const FileReaderOptions& options = { })
 {
-    deserialize_from_file<DefaultSerializer<Type>>(path, value, endian);
+    deserialize_from_file<DefaultSerializer<Type>>(path, value, archive_options, options);
 }
 
 }
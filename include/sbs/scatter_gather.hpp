@@ -0,0 +1,244 @@
+#ifndef SBS_SCATTER_GATHER_HPP
+#define SBS_SCATTER_GATHER_HPP
+
+#include <sbs/sbs.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace sbs {
+
+struct ScatterGatherOptions {
+    // Spans of at least this many bytes archived with `Archive::reference_span`, such as by `ReferenceSerializer`, are
+    // referenced instead of copied. Below it, copying is cheaper than another segment.
+    size_t min_reference_size = 4096;
+};
+
+// Archives a contiguous container of values, such as a `std::vector<std::byte>` or `std::string`, in the same format
+// as its default serializer, which is used for deserialization. When serializing, writers that support it, such as
+// `ScatterGatherWriter`, reference the elements instead of copying them.
+//
+// The default serializers always copy, since containers are also archived from temporaries such as the key copies of
+// the map serializers. Only use this serializer for containers that stay alive and unmodified until the writer's output
+// has been consumed.
+template <class Container>
+    requires(
+        std::ranges::contiguous_range<Container> && std::ranges::sized_range<Container>
+        && ValueSerializable<std::remove_const_t<std::ranges::range_value_t<Container>>>
+        && DefaultSerializable<Container>)
+struct ReferenceSerializer {
+    void operator()(Archive& ar, Container& container) const
+    {
+        if (ar.serializing()) {
+            using Value = std::remove_const_t<std::ranges::range_value_t<Container>>;
+            // Arrays have a fixed size so their size is not archived.
+            if constexpr (!requires { std::tuple_size<Container>::value; }) {
+                uint64_t size = std::ranges::size(container);
+                ar.archive_size(size);
+            }
+            // Serializing does not modify the elements.
+            ar.reference_span(
+                std::span<Value>(const_cast<Value*>(std::ranges::data(container)), std::ranges::size(container)));
+        } else {
+            DefaultSerializer<Container>()(ar, container);
+        }
+    }
+};
+
+// Collects the output as a list of segments instead of a single buffer. Small values are copied into a staging
+// buffer while large contiguous payloads are only referenced, so the payloads are never duplicated on their way to a
+// file or socket, which receives every segment in one vectored write with `write_to`.
+//
+// Only spans archived with `Archive::reference_span`, such as by `ReferenceSerializer`, are referenced. They point into
+// the serialized value, which must stay alive and unmodified until the output has been written.
+class ScatterGatherWriter {
+public:
+    explicit ScatterGatherWriter(const ScatterGatherOptions& options = { })
+        : m_min_reference_size { options.min_reference_size }
+    {
+    }
+
+    void write(const std::span<const std::byte> bytes)
+    {
+        const std::span<std::byte> buffer = prepare(bytes.size());
+        std::memcpy(buffer.data(), bytes.data(), bytes.size());
+        commit(bytes.size());
+    }
+
+    std::span<std::byte> prepare(const size_t size)
+    {
+        if (m_staging_capacity - m_staged_size < size) {
+            reallocate(std::max({ m_staged_size + size, m_staging_capacity * 2, min_staging_capacity }));
+        }
+        return { m_staging.get() + m_staged_size, m_staging_capacity - m_staged_size };
+    }
+
+    void commit(const size_t size)
+    {
+        if (size == 0) {
+            return;
+        }
+        if (m_segments.empty() || m_segments.back().data != nullptr) {
+            m_segments.push_back({ .data = nullptr, .offset = m_staged_size, .size = 0 });
+        }
+        m_segments.back().size += size;
+        m_staged_size += size;
+        m_size += size;
+    }
+
+    void reference(const std::span<const std::byte> bytes)
+    {
+        if (bytes.empty()) {
+            return;
+        }
+        m_segments.push_back({ .data = bytes.data(), .offset = 0, .size = bytes.size() });
+        m_size += bytes.size();
+    }
+
+    [[nodiscard]] size_t min_reference_size() const
+    {
+        return m_min_reference_size;
+    }
+
+    // Total number of bytes written, including referenced bytes.
+    [[nodiscard]] size_t size() const
+    {
+        return m_size;
+    }
+
+    // The output in order. Staged segments are valid until the next call to a non-const method.
+    [[nodiscard]] std::vector<std::span<const std::byte>> segments() const
+    {
+        std::vector<std::span<const std::byte>> segments;
+        segments.reserve(m_segments.size());
+        for (const Segment& segment : m_segments) {
+            segments.push_back(resolve(segment));
+        }
+        return segments;
+    }
+
+    // Discards the output while keeping the staging buffer's capacity.
+    void clear()
+    {
+        m_segments.clear();
+        m_staged_size = 0;
+        m_size = 0;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // Writes the output to a file descriptor with `writev`, in as few calls as the system allows. The descriptor must
+    // be blocking.
+    void write_to(const int file) const
+    {
+        std::vector<iovec> iovecs;
+        iovecs.reserve(m_segments.size());
+        for (const Segment& segment : m_segments) {
+            const std::span<const std::byte> bytes = resolve(segment);
+            iovecs.push_back({ .iov_base = const_cast<std::byte*>(bytes.data()), .iov_len = bytes.size() });
+        }
+        size_t index = 0;
+        while (index < iovecs.size()) {
+            const auto count = static_cast<int>(std::min(iovecs.size() - index, max_iovecs));
+            const ssize_t written = ::writev(file, iovecs.data() + index, count);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Error writing scatter-gather output");
+            }
+            // Skips the fully written segments and advances into a partially written one.
+            auto remaining = static_cast<size_t>(written);
+            while (index < iovecs.size() && remaining >= iovecs[index].iov_len) {
+                remaining -= iovecs[index].iov_len;
+                ++index;
+            }
+            if (remaining > 0) {
+                iovecs[index].iov_base = static_cast<std::byte*>(iovecs[index].iov_base) + remaining;
+                iovecs[index].iov_len -= remaining;
+            }
+        }
+    }
+#endif
+
+private:
+    // Staged segments store an offset into the staging buffer since it moves as it grows.
+    struct Segment {
+        const std::byte* data;
+        size_t offset;
+        size_t size;
+    };
+
+    static constexpr size_t min_staging_capacity = 256;
+    // The smallest `IOV_MAX` of common systems.
+    static constexpr size_t max_iovecs = 1024;
+
+    size_t m_min_reference_size;
+    std::unique_ptr<std::byte[]> m_staging;
+    size_t m_staging_capacity { };
+    size_t m_staged_size { };
+    std::vector<Segment> m_segments;
+    size_t m_size { };
+
+    [[nodiscard]] std::span<const std::byte> resolve(const Segment& segment) const
+    {
+        return { segment.data == nullptr ? m_staging.get() + segment.offset : segment.data, segment.size };
+    }
+
+    void reallocate(const size_t capacity)
+    {
+        auto staging = std::make_unique_for_overwrite<std::byte[]>(capacity);
+        if (m_staged_size > 0) {
+            std::memcpy(staging.get(), m_staging.get(), m_staged_size);
+        }
+        m_staging = std::move(staging);
+        m_staging_capacity = capacity;
+    }
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+// Serializes a value to a file descriptor, such as a socket or pipe, with large payloads written straight from the
+// value rather than copied into an output buffer first.
+template <class TypeSerializer, class Type>
+    requires(Serializer<TypeSerializer, Type>)
+void serialize_to_fd(
+    const int file,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const ScatterGatherOptions& options = { })
+{
+    ScatterGatherWriter writer { options };
+    serialize_using_writer<TypeSerializer>(value, writer, archive_options);
+    writer.write_to(file);
+}
+
+template <class Type>
+    requires(DefaultSerializable<Type>)
+void serialize_to_fd(
+    const int file,
+    Type& value,
+    const ArchiveOptions& archive_options = { },
+    const ScatterGatherOptions& options = { })
+{
+    serialize_to_fd<DefaultSerializer<Type>>(file, value, archive_options, options);
+}
+#endif
+
+}
+
+#endif // SBS_SCATTER_GATHER_HPP
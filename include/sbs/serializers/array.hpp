@@ -12,8 +12,12 @@ template <class Type, std::size_t size, class TypeSerializer = DefaultSerializer
 struct ArraySerializer {
     void operator()(Archive& ar, std::array<Type, size>& array) const
     {
-        for (Type& element : array) {
-            ar.archive<TypeSerializer>(element);
+        if constexpr (SpanSerializable<TypeSerializer, Type>) {
+            ar.archive_span(std::span<Type>(array));
+        } else {
+            for (Type& element : array) {
+                ar.archive<TypeSerializer>(element);
+            }
         }
     }
 };
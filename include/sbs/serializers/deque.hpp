@@ -4,6 +4,7 @@
 #include <sbs/sbs.hpp>
 
 #include <cstdint>
+#include <stdexcept>
 #include <deque>
 
 namespace sbs {
@@ -15,17 +16,20 @@ struct DequeSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = deque.size();
-            ar.archive(size);
+            ar.archive_size(size);
             for (Type& element : deque) {
                 ar.archive<TypeSerializer>(element);
             }
         } else {
             deque.clear();
             uint64_t size = 0;
-            ar.archive(size);
-            deque.resize(size);
-            for (Type& element : deque) {
-                ar.archive<TypeSerializer>(element);
+            ar.archive_size(size);
+            if (size > deque.max_size()) {
+                throw std::runtime_error("Length exceeds the maximum");
+            }
+            for (uint64_t i = 0; i < size; ++i) {
+                ar.charge_memory(sizeof(Type));
+                ar.archive<TypeSerializer>(deque.emplace_back());
             }
         }
     }
@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <forward_list>
+#include <stdexcept>
 
 namespace sbs {
 
@@ -14,18 +15,35 @@ struct ForwardListSerializer {
     void operator()(Archive& ar, std::forward_list<Type, Allocator>& forward_list) const
     {
         if (ar.serializing()) {
+            // The list can only be walked once to count and archive its elements if the size can be patched in
+            // afterwards, and with identical output, which varints padded to their maximum width do not have.
+            if (ar.can_reserve_size() && ar.options().size_encoding == SizeEncoding::fixed) {
+                const SizeSlot slot = ar.reserve_size();
+                uint64_t size = 0;
+                for (Type& element : forward_list) {
+                    ar.archive<TypeSerializer>(element);
+                    ++size;
+                }
+                ar.patch_size(slot, size);
+                return;
+            }
             uint64_t size = std::distance(forward_list.begin(), forward_list.end());
-            ar.archive(size);
+            ar.archive_size(size);
             for (Type& element : forward_list) {
                 ar.archive<TypeSerializer>(element);
             }
         } else {
             forward_list.clear();
             uint64_t size = 0;
-            ar.archive(size);
-            forward_list.resize(size);
-            for (Type& element : forward_list) {
-                ar.archive<TypeSerializer>(element);
+            ar.archive_size(size);
+            if (size > forward_list.max_size()) {
+                throw std::runtime_error("Length exceeds the maximum");
+            }
+            auto last = forward_list.before_begin();
+            for (uint64_t i = 0; i < size; ++i) {
+                ar.charge_memory(sizeof(Type));
+                last = forward_list.emplace_after(last);
+                ar.archive<TypeSerializer>(*last);
             }
         }
     }
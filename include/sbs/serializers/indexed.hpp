@@ -0,0 +1,377 @@
+#ifndef SBS_SERIALIZERS_INDEXED_HPP
+#define SBS_SERIALIZERS_INDEXED_HPP
+
+#include <sbs/sbs.hpp>
+#include <sbs/thread_pool.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sbs {
+
+struct IndexOptions {
+    // Number of elements between entries in the offset index. Smaller strides allow finer random access and
+    // parallelism at the cost of a larger index.
+    size_t stride = 1024;
+    // Vectors with fewer elements are serialized and deserialized on the calling thread.
+    size_t threshold = 16 * 1024;
+    // Number of threads that serialize and deserialize elements, where 0 uses one per hardware thread.
+    size_t threads = 0;
+};
+
+namespace detail {
+
+// The elements of an indexed vector are split into groups of `stride` elements whose serialized byte lengths make
+// up the index.
+struct IndexedLayout {
+    uint64_t size;
+    uint64_t stride;
+    // Byte offset of each group in the data followed by the total data size.
+    std::vector<uint64_t> offsets;
+
+    [[nodiscard]] size_t group_count() const
+    {
+        return offsets.size() - 1;
+    }
+
+    void archive_header(Archive& ar)
+    {
+        ar.archive_size(size);
+        ar.archive_size(stride);
+        if (ar.deserializing()) {
+            if (size > 0 && stride == 0) {
+                throw std::runtime_error("Invalid index stride");
+            }
+            const uint64_t groups = size == 0 ? 0 : (size - 1) / stride + 1;
+            offsets.assign(1, 0);
+            // Every length takes at least one byte, so the table grows only as its lengths are read.
+            while (offsets.size() - 1 < groups) {
+                const size_t count = ar.allocation_count(groups - (offsets.size() - 1), sizeof(uint64_t), 1);
+                for (size_t i = 0; i < count; ++i) {
+                    uint64_t length = 0;
+                    ar.archive_varint(length);
+                    if (length > std::numeric_limits<uint64_t>::max() - offsets.back()) {
+                        throw std::runtime_error("Invalid index offset");
+                    }
+                    offsets.push_back(offsets.back() + length);
+                }
+            }
+        } else {
+            for (size_t group = 0; group < group_count(); ++group) {
+                uint64_t length = offsets[group + 1] - offsets[group];
+                ar.archive_varint(length);
+            }
+        }
+    }
+};
+
+template <class Function>
+void for_each_group_range(const size_t group_count, const size_t threads, Function function)
+{
+    if (group_count == 0) {
+        return;
+    }
+    // Waiting for the pool from one of its workers could deadlock, so nested indexed vectors run serially.
+    if (threads <= 1 || group_count == 1 || ThreadPool::on_worker_thread()) {
+        function(0, group_count);
+        return;
+    }
+    const size_t task_count = std::min(group_count, threads * 4);
+    std::vector<std::future<void>> futures;
+    futures.reserve(task_count);
+    ThreadPool& pool = shared_thread_pool(threads);
+    for (size_t task = 0; task < task_count; ++task) {
+        const size_t begin = group_count * task / task_count;
+        const size_t end = group_count * (task + 1) / task_count;
+        futures.push_back(pool.submit([&function, begin, end] { function(begin, end); }));
+    }
+    // Every task must finish before returning since they reference the caller's data, even if one throws.
+    std::exception_ptr error;
+    for (std::future<void>& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (error == nullptr) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error != nullptr) {
+        std::rethrow_exception(error);
+    }
+}
+
+}
+
+// Serializes a vector with an offset index of every `IndexOptions::stride` elements in front of the elements. Large
+// vectors are serialized and deserialized on multiple threads, each handling disjoint groups of elements, and single
+// elements can be read without deserializing the elements before them with `IndexedVectorView`. The format differs
+// from `VectorSerializer`: the size and stride, the byte length of each group as a varint, then the elements.
+template <
+    class Type,
+    class TypeSerializer = DefaultSerializer<Type>,
+    IndexOptions Options = IndexOptions { },
+    class Allocator = std::allocator<Type>>
+    requires(sbs::Serializer<TypeSerializer, Type> && std::is_default_constructible_v<Type>)
+struct IndexedVectorSerializer {
+    void operator()(Archive& ar, std::vector<Type, Allocator>& vector) const
+    {
+        if (ar.deserializing()) {
+            deserialize(ar, vector);
+        } else {
+            serialize(ar, vector);
+        }
+    }
+
+private:
+    static size_t thread_count(const size_t size)
+    {
+        return size < Options.threshold ? 1 : detail::resolve_thread_count(Options.threads);
+    }
+
+    static void serialize(Archive& ar, std::vector<Type, Allocator>& vector)
+    {
+        const size_t stride = std::max<size_t>(Options.stride, 1);
+        detail::IndexedLayout layout { .size = vector.size(), .stride = stride, .offsets = { } };
+        const size_t group_count = vector.empty() ? 0 : (vector.size() - 1) / stride + 1;
+        // Each range of groups is serialized into the buffer of its first group so that ranges can be serialized
+        // concurrently and then concatenated. Counting only needs the group lengths, so nothing is buffered.
+        std::vector<std::vector<std::byte>> buffers(group_count);
+        std::vector<uint64_t> lengths(group_count);
+        detail::for_each_group_range(
+            group_count, thread_count(vector.size()), [&](const size_t begin_group, const size_t end_group) {
+                VectorWriter writer { buffers[begin_group] };
+                auto group_ar = ar.counting() ? Archive::create_for_counting(ar.options())
+                                              : Archive::create_for_serializing(writer, ar.options());
+                size_t offset = 0;
+                for (size_t group = begin_group; group < end_group; ++group) {
+                    const size_t end = std::min(vector.size(), (group + 1) * stride);
+                    for (size_t i = group * stride; i < end; ++i) {
+                        group_ar.archive<TypeSerializer>(vector[i]);
+                    }
+                    group_ar.sync();
+                    const size_t size = ar.counting() ? group_ar.counted_size() : writer.size();
+                    lengths[group] = size - offset;
+                    offset = size;
+                }
+            });
+        layout.offsets.assign(1, 0);
+        for (const uint64_t length : lengths) {
+            layout.offsets.push_back(layout.offsets.back() + length);
+        }
+        layout.archive_header(ar);
+        if (ar.counting()) {
+            ar.count_bytes(static_cast<size_t>(layout.offsets.back()));
+            return;
+        }
+        for (std::vector<std::byte>& buffer : buffers) {
+            ar.archive_span(std::span<std::byte>(buffer));
+            buffer = { };
+        }
+    }
+
+    static void deserialize(Archive& ar, std::vector<Type, Allocator>& vector)
+    {
+        detail::IndexedLayout layout { };
+        layout.archive_header(ar);
+        const uint64_t data_size = layout.offsets.back();
+        std::vector<std::byte> buffer;
+        std::span<const std::byte> data;
+        if (ar.can_borrow()) {
+            data = ar.borrow_span<std::byte>(data_size);
+        } else {
+            while (buffer.size() < data_size) {
+                const size_t begin = buffer.size();
+                buffer.resize(begin + ar.allocation_count(data_size - begin, 1, 1));
+                ar.archive_span(std::span<std::byte>(buffer).subspan(begin));
+            }
+            data = buffer;
+        }
+        if (layout.size > vector.max_size()) {
+            throw std::runtime_error("Length exceeds the maximum");
+        }
+        const auto size = static_cast<size_t>(layout.size);
+        const auto stride = static_cast<size_t>(std::min(layout.stride, layout.size));
+        vector.clear();
+        // Elements of a fixed size must exactly fill the data that was read, so they are allocated at once.
+        if constexpr (constexpr size_t element_size = fixed_serialized_size<TypeSerializer, Type>; element_size > 0) {
+            if (size > data_size / element_size || size * element_size != data_size) {
+                throw std::runtime_error("Invalid index offset");
+            }
+            if (size > std::numeric_limits<uint64_t>::max() / sizeof(Type)) {
+                throw std::runtime_error("Memory budget exceeded");
+            }
+            ar.charge_memory(static_cast<uint64_t>(size) * sizeof(Type));
+            vector.resize(size);
+        }
+        // Other elements are allocated ahead of the groups read so far by a bounded chunk, or by up to as many elements
+        // as were read so that large vectors still take few concurrent batches, and a corrupt size is only allocated as
+        // its elements are read. The groups of a batch are deserialized concurrently, so the vector cannot grow
+        // during a batch. With a memory budget, groups are deserialized serially so that each can be given what the
+        // previous ones left of it.
+        const bool budgeted = ar.options().memory_budget != std::numeric_limits<uint64_t>::max();
+        const size_t threads = budgeted ? 1 : thread_count(size);
+        size_t group = 0;
+        while (group < layout.group_count()) {
+            const size_t begin = group * stride;
+            const size_t group_end = std::min(size, begin + stride);
+            if (vector.size() < group_end) {
+                grow(ar, vector, size, begin);
+            }
+            if (vector.size() < group_end) {
+                deserialize_large_group(ar, vector, size, stride, layout, data, group);
+                ++group;
+                continue;
+            }
+            const size_t end_group = vector.size() == size ? layout.group_count() : vector.size() / stride;
+            detail::for_each_group_range(
+                end_group - group, threads, [&](const size_t begin_task_group, const size_t end_task_group) {
+                    deserialize_groups(
+                        ar,
+                        vector,
+                        stride,
+                        layout,
+                        data,
+                        group + begin_task_group,
+                        group + end_task_group);
+                });
+            group = end_group;
+        }
+    }
+
+    // Grows the vector by a bounded chunk of elements, or by up to the `read` elements already deserialized, charging
+    // them against the memory budget.
+    static void grow(Archive& ar, std::vector<Type, Allocator>& vector, const size_t size, const size_t read)
+    {
+        const size_t remaining = size - vector.size();
+        size_t count = ar.allocation_count(remaining, sizeof(Type));
+        if (count < std::min(read, remaining)) {
+            ar.charge_memory(static_cast<uint64_t>(std::min(read, remaining) - count) * sizeof(Type));
+            count = std::min(read, remaining);
+        }
+        vector.resize(vector.size() + count);
+    }
+
+    // Allocations by the elements, such as the characters of strings, are charged to `ar` once the groups are read.
+    // Without a memory budget the groups of a batch run concurrently and nothing needs to be charged.
+    static void deserialize_groups(
+        Archive& ar,
+        std::vector<Type, Allocator>& vector,
+        const size_t stride,
+        const detail::IndexedLayout& layout,
+        const std::span<const std::byte> data,
+        const size_t begin_group,
+        const size_t end_group)
+    {
+        const uint64_t begin_offset = layout.offsets[begin_group];
+        const uint64_t end_offset = layout.offsets[end_group];
+        SpanReader reader { data.subspan(begin_offset, end_offset - begin_offset) };
+        const bool budgeted = ar.options().memory_budget != std::numeric_limits<uint64_t>::max();
+        ArchiveOptions options = ar.options();
+        if (budgeted) {
+            options.memory_budget = ar.memory_budget_remaining();
+        }
+        auto group_ar = Archive::create_for_deserializing(reader, options);
+        const size_t end = std::min(vector.size(), end_group * stride);
+        for (size_t i = begin_group * stride; i < end; ++i) {
+            group_ar.archive<TypeSerializer>(vector[i]);
+        }
+        group_ar.sync();
+        if (!reader.remaining().empty()) {
+            throw std::runtime_error("Invalid index offset");
+        }
+        if (budgeted) {
+            ar.charge_memory(options.memory_budget - group_ar.memory_budget_remaining());
+        }
+    }
+
+    // Deserializes a group with more elements than the vector may grow by at once, growing it as the elements are
+    // read.
+    static void deserialize_large_group(
+        Archive& ar,
+        std::vector<Type, Allocator>& vector,
+        const size_t size,
+        const size_t stride,
+        const detail::IndexedLayout& layout,
+        const std::span<const std::byte> data,
+        const size_t group)
+    {
+        const uint64_t begin_offset = layout.offsets[group];
+        const uint64_t end_offset = layout.offsets[group + 1];
+        SpanReader reader { data.subspan(begin_offset, end_offset - begin_offset) };
+        // The group is given what is left of the budget, and what it used is charged back once it is read.
+        ArchiveOptions options = ar.options();
+        options.memory_budget = ar.memory_budget_remaining();
+        auto group_ar = Archive::create_for_deserializing(reader, options);
+        const size_t begin = group * stride;
+        const size_t end = std::min(size, begin + stride);
+        for (size_t i = begin; i < end; ++i) {
+            if (i == vector.size()) {
+                grow(ar, vector, size, i);
+            }
+            group_ar.archive<TypeSerializer>(vector[i]);
+        }
+        group_ar.sync();
+        if (!reader.remaining().empty()) {
+            throw std::runtime_error("Invalid index offset");
+        }
+        ar.charge_memory(options.memory_budget - group_ar.memory_budget_remaining());
+    }
+};
+
+// Reads single elements from the bytes of a vector serialized with `IndexedVectorSerializer`, only deserializing
+// the elements of the group containing the element. `bytes` must start with the serialized vector and outlive the
+// view.
+template <class Type, class TypeSerializer = DefaultSerializer<Type>>
+    requires(sbs::Serializer<TypeSerializer, Type> && std::is_default_constructible_v<Type>)
+class IndexedVectorView {
+public:
+    explicit IndexedVectorView(const std::span<const std::byte> bytes, const ArchiveOptions& archive_options = { })
+        : m_archive_options { archive_options }
+    {
+        SpanReader reader { bytes };
+        auto ar = Archive::create_for_deserializing(reader, archive_options);
+        m_layout.archive_header(ar);
+        ar.sync();
+        if (reader.remaining().size() < m_layout.offsets.back()) {
+            throw std::runtime_error("Insufficient data to deserialize");
+        }
+        m_data = reader.remaining().first(static_cast<size_t>(m_layout.offsets.back()));
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return static_cast<size_t>(m_layout.size);
+    }
+
+    [[nodiscard]] Type at(const size_t index) const
+    {
+        if (index >= m_layout.size) {
+            throw std::out_of_range("Index out of range");
+        }
+        const size_t group = index / m_layout.stride;
+        SpanReader reader { m_data.subspan(m_layout.offsets[group]) };
+        auto ar = Archive::create_for_deserializing(reader, m_archive_options);
+        Type value { };
+        for (size_t i = group * m_layout.stride; i <= index; ++i) {
+            value = Type { };
+            ar.archive<TypeSerializer>(value);
+        }
+        return value;
+    }
+
+private:
+    ArchiveOptions m_archive_options;
+    detail::IndexedLayout m_layout { };
+    std::span<const std::byte> m_data;
+};
+
+}
+
+#endif // SBS_SERIALIZERS_INDEXED_HPP
@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <list>
+#include <stdexcept>
 
 namespace sbs {
 
@@ -15,17 +16,20 @@ struct ListSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = list.size();
-            ar.archive(size);
+            ar.archive_size(size);
             for (Type& element : list) {
                 ar.archive<TypeSerializer>(element);
             }
         } else {
             list.clear();
             uint64_t size = 0;
-            ar.archive(size);
-            list.resize(size);
-            for (Type& element : list) {
-                ar.archive<TypeSerializer>(element);
+            ar.archive_size(size);
+            if (size > list.max_size()) {
+                throw std::runtime_error("Length exceeds the maximum");
+            }
+            for (uint64_t i = 0; i < size; ++i) {
+                ar.charge_memory(sizeof(Type));
+                ar.archive<TypeSerializer>(list.emplace_back());
             }
         }
     }
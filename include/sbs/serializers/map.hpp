@@ -4,6 +4,7 @@
 #include <sbs/sbs.hpp>
 
 #include <cstdint>
+#include <memory>
 #include <map>
 
 namespace sbs {
@@ -23,7 +24,7 @@ struct MapSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = map.size();
-            ar.archive(size);
+            ar.archive_size(size);
             for (auto& [key, value] : map) {
                 Key key_copy = key;
                 ar.archive<KeySerializer>(key_copy);
@@ -32,13 +33,14 @@ struct MapSerializer {
         } else {
             map.clear();
             uint64_t size = 0;
-            ar.archive(size);
+            ar.archive_size(size);
             for (uint64_t i = 0; i < size; ++i) {
-                auto key = Key();
+                ar.charge_memory(sizeof(std::pair<const Key, Value>));
+                auto key = std::make_obj_using_allocator<Key>(map.get_allocator());
                 ar.archive<KeySerializer>(key);
-                auto value = Value();
+                auto value = std::make_obj_using_allocator<Value>(map.get_allocator());
                 ar.archive<ValueSerializer>(value);
-                map.insert({ std::move(key), std::move(value) });
+                map.emplace(std::move(key), std::move(value));
             }
         }
     }
@@ -59,7 +61,7 @@ struct MultimapSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = multimap.size();
-            ar.archive(size);
+            ar.archive_size(size);
             for (auto& [key, value] : multimap) {
                 Key key_copy = key;
                 ar.archive<KeySerializer>(key_copy);
@@ -68,13 +70,14 @@ struct MultimapSerializer {
         } else {
             multimap.clear();
             uint64_t size = 0;
-            ar.archive(size);
+            ar.archive_size(size);
             for (uint64_t i = 0; i < size; ++i) {
-                auto key = Key();
+                ar.charge_memory(sizeof(std::pair<const Key, Value>));
+                auto key = std::make_obj_using_allocator<Key>(multimap.get_allocator());
                 ar.archive<KeySerializer>(key);
-                auto value = Value();
+                auto value = std::make_obj_using_allocator<Value>(multimap.get_allocator());
                 ar.archive<ValueSerializer>(value);
-                multimap.insert({ std::move(key), std::move(value) });
+                multimap.emplace(std::move(key), std::move(value));
             }
         }
     }
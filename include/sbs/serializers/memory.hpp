@@ -4,9 +4,22 @@
 #include <sbs/sbs.hpp>
 
 #include <memory>
+#include <memory_resource>
 
 namespace sbs {
 
+// Deleter for values allocated from a memory resource, which `UniquePtrSerializer` allocates from the archive's
+// memory resource when deserializing. See `ArchiveOptions::memory_resource`.
+template <class Type>
+struct ResourceDeleter {
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+
+    void operator()(Type* pointer) const
+    {
+        std::pmr::polymorphic_allocator<>(resource).delete_object(pointer);
+    }
+};
+
 template <class Type, class TypeSerializer = DefaultSerializer<Type>, class Deleter = std::default_delete<Type>>
     requires(sbs::Serializer<TypeSerializer, Type> && std::is_default_constructible_v<Type>)
 struct UniquePtrSerializer {
@@ -22,14 +35,25 @@ struct UniquePtrSerializer {
             bool has_value = false;
             ar.archive(has_value);
             if (has_value) {
-                auto value = std::unique_ptr<Type, Deleter>(new Type());
-                ar.archive(*value);
+                auto value = make_unique_value(ar);
+                ar.archive<TypeSerializer>(*value);
                 unique_ptr = std::move(value);
             } else {
                 unique_ptr.reset();
             }
         }
     }
+
+private:
+    static std::unique_ptr<Type, Deleter> make_unique_value(const Archive& ar)
+    {
+        if constexpr (std::is_same_v<Deleter, ResourceDeleter<Type>>) {
+            std::pmr::polymorphic_allocator<> allocator { ar.memory_resource() };
+            return { allocator.new_object<Type>(), Deleter { ar.memory_resource() } };
+        } else {
+            return std::unique_ptr<Type, Deleter>(new Type());
+        }
+    }
 };
 
 template <class Type, class TypeSerializer = DefaultSerializer<Type>, class Deleter = std::default_delete<Type>>
@@ -23,7 +23,7 @@ struct OptionalSerializer {
             bool has_value = false;
             ar.archive(has_value);
             if (has_value) {
-                auto value = Type();
+                auto value = ar.make_value<Type>();
                 ar.archive<TypeSerializer>(value);
                 optional = std::move(value);
             }
@@ -0,0 +1,153 @@
+#ifndef SBS_SERIALIZERS_PARALLEL_HPP
+#define SBS_SERIALIZERS_PARALLEL_HPP
+
+#include <sbs/sbs.hpp>
+#include <sbs/thread_pool.hpp>
+
+#include <sbs/serializers/array.hpp>
+#include <sbs/serializers/deque.hpp>
+#include <sbs/serializers/vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <span>
+#include <vector>
+
+namespace sbs {
+
+struct ParallelOptions {
+    // Containers with fewer elements are serialized serially.
+    size_t threshold = 16 * 1024;
+    // Number of threads that serialize elements, where 0 uses one per hardware thread.
+    size_t threads = 0;
+    // Minimum number of elements serialized into each buffer, so that small containers are not split into buffers that
+    // cost more to hand between threads than to serialize. Containers that would have a single chunk are serialized
+    // serially.
+    size_t min_chunk_size = 1024;
+};
+
+namespace detail {
+
+// When serializing, archives the elements in chunks on a thread pool, each into its own buffer using an archive with
+// the same options, and writes the buffers in order so the output is identical to archiving the elements serially.
+template <class TypeSerializer, ParallelOptions Options, class Range>
+void serialize_items_parallel(Archive& ar, Range& items)
+{
+    const size_t size = std::ranges::size(items);
+    const size_t threads = resolve_thread_count(Options.threads);
+    const size_t chunk_count = std::min(threads * 4, size / std::max<size_t>(Options.min_chunk_size, 1));
+    // Nested parallel containers are serialized serially by the workers, since waiting for the pool from one of its
+    // workers could deadlock.
+    if (ar.deserializing() || ar.counting() || size < Options.threshold || threads <= 1 || chunk_count <= 1
+        || ThreadPool::on_worker_thread()) {
+        for (auto& item : items) {
+            ar.archive<TypeSerializer>(item);
+        }
+        return;
+    }
+    ThreadPool& pool = shared_thread_pool(threads);
+    std::vector<std::vector<std::byte>> buffers(chunk_count);
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunk_count);
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        const size_t begin = size * chunk / chunk_count;
+        const size_t end = size * (chunk + 1) / chunk_count;
+        futures.push_back(pool.submit([&, chunk, begin, end] {
+            VectorWriter writer { buffers[chunk] };
+            auto chunk_ar = Archive::create_for_serializing(writer, ar.options());
+            for (size_t i = begin; i < end; ++i) {
+                chunk_ar.archive<TypeSerializer>(items[i]);
+            }
+            chunk_ar.sync();
+        }));
+    }
+    // Every task must finish before returning since they reference the buffers and items, even if one throws.
+    std::exception_ptr error;
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        try {
+            futures[chunk].get();
+            if (error == nullptr) {
+                ar.archive_span(std::span<std::byte>(buffers[chunk]));
+            }
+        } catch (...) {
+            if (error == nullptr) {
+                error = std::current_exception();
+            }
+        }
+        buffers[chunk] = { };
+    }
+    if (error != nullptr) {
+        std::rethrow_exception(error);
+    }
+}
+
+}
+
+// Serializes large vectors on multiple threads with output identical to `VectorSerializer`, which is used for
+// deserialization. Vectors of values archived in bulk are always serialized serially since that is a single copy.
+template <
+    class Type,
+    class TypeSerializer = DefaultSerializer<Type>,
+    ParallelOptions Options = ParallelOptions { },
+    class Allocator = std::allocator<Type>>
+    requires(sbs::Serializer<TypeSerializer, Type> && std::is_default_constructible_v<Type>)
+struct ParallelVectorSerializer {
+    void operator()(Archive& ar, std::vector<Type, Allocator>& vector) const
+    {
+        if (ar.deserializing() || SpanSerializable<TypeSerializer, Type>) {
+            VectorSerializer<Type, TypeSerializer, Allocator>()(ar, vector);
+        } else {
+            uint64_t size = vector.size();
+            ar.archive_size(size);
+            detail::serialize_items_parallel<TypeSerializer, Options>(ar, vector);
+        }
+    }
+};
+
+// Serializes large deques on multiple threads with output identical to `DequeSerializer`, which is used for
+// deserialization.
+template <
+    class Type,
+    class TypeSerializer = DefaultSerializer<Type>,
+    ParallelOptions Options = ParallelOptions { },
+    class Allocator = std::allocator<Type>>
+    requires(sbs::Serializer<TypeSerializer, Type> && std::is_default_constructible_v<Type>)
+struct ParallelDequeSerializer {
+    void operator()(Archive& ar, std::deque<Type, Allocator>& deque) const
+    {
+        if (ar.deserializing()) {
+            DequeSerializer<Type, TypeSerializer, Allocator>()(ar, deque);
+        } else {
+            uint64_t size = deque.size();
+            ar.archive_size(size);
+            detail::serialize_items_parallel<TypeSerializer, Options>(ar, deque);
+        }
+    }
+};
+
+// Serializes large arrays on multiple threads with output identical to `ArraySerializer`, which is used for
+// deserialization. Arrays of values archived in bulk are always serialized serially since that is a single copy.
+template <
+    class Type,
+    std::size_t size,
+    class TypeSerializer = DefaultSerializer<Type>,
+    ParallelOptions Options = ParallelOptions { }>
+    requires(sbs::Serializer<TypeSerializer, Type>)
+struct ParallelArraySerializer {
+    void operator()(Archive& ar, std::array<Type, size>& array) const
+    {
+        if (ar.deserializing() || SpanSerializable<TypeSerializer, Type>) {
+            ArraySerializer<Type, size, TypeSerializer>()(ar, array);
+        } else {
+            detail::serialize_items_parallel<TypeSerializer, Options>(ar, array);
+        }
+    }
+};
+
+}
+
+#endif // SBS_SERIALIZERS_PARALLEL_HPP
@@ -4,6 +4,7 @@
 #include <sbs/sbs.hpp>
 
 #include <cstdint>
+#include <memory>
 #include <set>
 
 namespace sbs {
@@ -19,7 +20,7 @@ struct SetSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = set.size();
-            ar.archive(size);
+            ar.archive_size(size);
             for (const Key& key : set) {
                 Key key_copy = key;
                 ar.archive<KeySerializer>(key_copy);
@@ -27,9 +28,10 @@ struct SetSerializer {
         } else {
             set.clear();
             uint64_t size = 0;
-            ar.archive(size);
+            ar.archive_size(size);
             for (uint64_t i = 0; i < size; ++i) {
-                auto key = Key();
+                ar.charge_memory(sizeof(Key));
+                auto key = std::make_obj_using_allocator<Key>(set.get_allocator());
                 ar.archive<KeySerializer>(key);
                 set.insert(std::move(key));
             }
@@ -48,7 +50,7 @@ struct MultisetSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = multiset.size();
-            ar.archive(size);
+            ar.archive_size(size);
             for (const Key& key : multiset) {
                 Key key_copy = key;
                 ar.archive<KeySerializer>(key_copy);
@@ -56,9 +58,10 @@ struct MultisetSerializer {
         } else {
             multiset.clear();
             uint64_t size = 0;
-            ar.archive(size);
+            ar.archive_size(size);
             for (uint64_t i = 0; i < size; ++i) {
-                auto key = Key();
+                ar.charge_memory(sizeof(Key));
+                auto key = std::make_obj_using_allocator<Key>(multiset.get_allocator());
                 ar.archive<KeySerializer>(key);
                 multiset.insert(std::move(key));
             }
@@ -0,0 +1,40 @@
+#ifndef SBS_SERIALIZERS_SPAN_HPP
+#define SBS_SERIALIZERS_SPAN_HPP
+
+#include <sbs/sbs.hpp>
+
+#include <cstdint>
+#include <span>
+
+namespace sbs {
+
+// Uses the same format as `VectorSerializer`. Deserialization borrows the elements from the input so it requires a
+// contiguous reader, and the span is only valid while the input is.
+template <class Type>
+    requires(sbs::ValueSerializable<Type>)
+struct ConstSpanSerializer {
+    void operator()(Archive& ar, std::span<const Type>& span) const
+    {
+        if (ar.serializing()) {
+            uint64_t size = span.size();
+            ar.archive_size(size);
+            // Serializing does not modify the elements.
+            ar.archive_span(std::span<Type>(const_cast<Type*>(span.data()), span.size()));
+        } else {
+            uint64_t size = 0;
+            ar.archive_size(size);
+            span = ar.borrow_span<Type>(size);
+        }
+    }
+};
+
+template <class Type>
+    requires(sbs::ValueSerializable<Type>)
+void serialize(Archive& ar, std::span<const Type>& span)
+{
+    ConstSpanSerializer<Type>()(ar, span);
+}
+
+}
+
+#endif // SBS_SERIALIZERS_SPAN_HPP
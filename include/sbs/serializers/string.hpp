@@ -4,6 +4,7 @@
 #include <sbs/sbs.hpp>
 
 #include <cstdint>
+#include <stdexcept>
 #include <string>
 
 namespace sbs {
@@ -19,16 +20,33 @@ struct BasicStringSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = string.size();
-            ar.archive(size);
-            for (auto& element : string) {
-                ar.archive<CharTypeSerializer>(element);
-            }
+            ar.archive_size(size);
+            archive_characters(ar, std::span<CharType>(string.data(), string.size()));
         } else {
             string.clear();
             uint64_t size = 0;
-            ar.archive(size);
-            string.resize(size);
-            for (auto& element : string) {
+            ar.archive_size(size);
+            if (size > string.max_size()) {
+                throw std::runtime_error("Length exceeds the maximum");
+            }
+            while (string.size() < size) {
+                const size_t begin = string.size();
+                string.resize(
+                    begin
+                    + ar.allocation_count(
+                        size - begin, sizeof(CharType), fixed_serialized_size<CharTypeSerializer, CharType>));
+                archive_characters(ar, std::span<CharType>(string.data(), string.size()).subspan(begin));
+            }
+        }
+    }
+
+private:
+    static void archive_characters(Archive& ar, const std::span<CharType> characters)
+    {
+        if constexpr (SpanSerializable<CharTypeSerializer, CharType>) {
+            ar.archive_span(characters);
+        } else {
+            for (auto& element : characters) {
                 ar.archive<CharTypeSerializer>(element);
             }
         }
@@ -0,0 +1,43 @@
+#ifndef SBS_SERIALIZERS_STRING_VIEW_HPP
+#define SBS_SERIALIZERS_STRING_VIEW_HPP
+
+#include <sbs/sbs.hpp>
+
+#include <cstdint>
+#include <string_view>
+
+namespace sbs {
+
+// Uses the same format as `BasicStringSerializer`. Deserialization borrows the characters from the input so it
+// requires a contiguous reader, and the view is only valid while the input is.
+template <class CharType, class Traits = std::char_traits<CharType>>
+    requires(sbs::ValueSerializable<CharType>)
+struct BasicStringViewSerializer {
+    void operator()(Archive& ar, std::basic_string_view<CharType, Traits>& string_view) const
+    {
+        if (ar.serializing()) {
+            uint64_t size = string_view.size();
+            ar.archive_size(size);
+            // Serializing does not modify the characters.
+            ar.archive_span(std::span<CharType>(const_cast<CharType*>(string_view.data()), string_view.size()));
+        } else {
+            uint64_t size = 0;
+            ar.archive_size(size);
+            const std::span<const CharType> characters = ar.borrow_span<CharType>(size);
+            string_view = std::basic_string_view<CharType, Traits>(characters.data(), characters.size());
+        }
+    }
+};
+
+using StringViewSerializer = BasicStringViewSerializer<char>;
+
+template <class CharType, class Traits = std::char_traits<CharType>>
+    requires(sbs::ValueSerializable<CharType>)
+void serialize(Archive& ar, std::basic_string_view<CharType, Traits>& basic_string_view)
+{
+    BasicStringViewSerializer<CharType, Traits>()(ar, basic_string_view);
+}
+
+}
+
+#endif // SBS_SERIALIZERS_STRING_VIEW_HPP
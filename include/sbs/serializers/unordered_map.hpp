@@ -4,6 +4,7 @@
 #include <sbs/sbs.hpp>
 
 #include <cstdint>
+#include <memory>
 #include <unordered_map>
 
 namespace sbs {
@@ -24,7 +25,7 @@ struct UnorderedMapSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = unordered_map.size();
-            ar.archive(size);
+            ar.archive_size(size);
             for (auto& [key, value] : unordered_map) {
                 Key key_copy = key;
                 ar.archive<KeySerializer>(key_copy);
@@ -33,14 +34,20 @@ struct UnorderedMapSerializer {
         } else {
             unordered_map.clear();
             uint64_t size = 0;
-            ar.archive(size);
-            unordered_map.reserve(size);
+            ar.archive_size(size);
+            // A fixed size key or value is a lower bound on the input taken by each pair, letting contiguous inputs
+            // reserve every bucket at once.
+            unordered_map.reserve(ar.allocation_count(
+                size,
+                sizeof(void*),
+                fixed_serialized_size<KeySerializer, Key> + fixed_serialized_size<ValueSerializer, Value>));
             for (uint64_t i = 0; i < size; ++i) {
-                auto key = Key();
+                ar.charge_memory(sizeof(std::pair<const Key, Value>));
+                auto key = std::make_obj_using_allocator<Key>(unordered_map.get_allocator());
                 ar.archive<KeySerializer>(key);
-                auto value = Value();
+                auto value = std::make_obj_using_allocator<Value>(unordered_map.get_allocator());
                 ar.archive<ValueSerializer>(value);
-                unordered_map.insert({ std::move(key), std::move(value) });
+                unordered_map.emplace(std::move(key), std::move(value));
             }
         }
     }
@@ -63,7 +70,7 @@ struct UnorderedMultimapSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = unordered_multimap.size();
-            ar.archive(size);
+            ar.archive_size(size);
             for (auto& [key, value] : unordered_multimap) {
                 Key key_copy = key;
                 ar.archive<KeySerializer>(key_copy);
@@ -72,14 +79,18 @@ struct UnorderedMultimapSerializer {
         } else {
             unordered_multimap.clear();
             uint64_t size = 0;
-            ar.archive(size);
-            unordered_multimap.reserve(size);
+            ar.archive_size(size);
+            unordered_multimap.reserve(ar.allocation_count(
+                size,
+                sizeof(void*),
+                fixed_serialized_size<KeySerializer, Key> + fixed_serialized_size<ValueSerializer, Value>));
             for (uint64_t i = 0; i < size; ++i) {
-                auto key = Key();
+                ar.charge_memory(sizeof(std::pair<const Key, Value>));
+                auto key = std::make_obj_using_allocator<Key>(unordered_multimap.get_allocator());
                 ar.archive<KeySerializer>(key);
-                auto value = Value();
+                auto value = std::make_obj_using_allocator<Value>(unordered_multimap.get_allocator());
                 ar.archive<ValueSerializer>(value);
-                unordered_multimap.insert({ std::move(key), std::move(value) });
+                unordered_multimap.emplace(std::move(key), std::move(value));
             }
         }
     }
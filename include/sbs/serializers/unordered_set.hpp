@@ -4,6 +4,7 @@
 #include <sbs/sbs.hpp>
 
 #include <cstdint>
+#include <memory>
 #include <unordered_set>
 
 namespace sbs {
@@ -20,7 +21,7 @@ struct UnorderedSetSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = unordered_set.size();
-            ar.archive(size);
+            ar.archive_size(size);
             for (const Key& key : unordered_set) {
                 Key key_copy = key;
                 ar.archive<KeySerializer>(key_copy);
@@ -28,10 +29,11 @@ struct UnorderedSetSerializer {
         } else {
             unordered_set.clear();
             uint64_t size = 0;
-            ar.archive(size);
-            unordered_set.reserve(size);
+            ar.archive_size(size);
+            unordered_set.reserve(ar.allocation_count(size, sizeof(void*), fixed_serialized_size<KeySerializer, Key>));
             for (uint64_t i = 0; i < size; ++i) {
-                auto key = Key();
+                ar.charge_memory(sizeof(Key));
+                auto key = std::make_obj_using_allocator<Key>(unordered_set.get_allocator());
                 ar.archive<KeySerializer>(key);
                 unordered_set.insert(std::move(key));
             }
@@ -51,7 +53,7 @@ struct UnorderedMultisetSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = unordered_multiset.size();
-            ar.archive(size);
+            ar.archive_size(size);
             for (const Key& key : unordered_multiset) {
                 Key key_copy = key;
                 ar.archive<KeySerializer>(key_copy);
@@ -59,10 +61,12 @@ struct UnorderedMultisetSerializer {
         } else {
             unordered_multiset.clear();
             uint64_t size = 0;
-            ar.archive(size);
-            unordered_multiset.reserve(size);
+            ar.archive_size(size);
+            unordered_multiset.reserve(
+                ar.allocation_count(size, sizeof(void*), fixed_serialized_size<KeySerializer, Key>));
             for (uint64_t i = 0; i < size; ++i) {
-                auto key = Key();
+                ar.charge_memory(sizeof(Key));
+                auto key = std::make_obj_using_allocator<Key>(unordered_multiset.get_allocator());
                 ar.archive<KeySerializer>(key);
                 unordered_multiset.insert(std::move(key));
             }
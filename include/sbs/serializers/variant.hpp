@@ -11,17 +11,16 @@ namespace sbs {
 namespace detail {
 
 template <class Variant, uint64_t Index = 0>
-void construct_variant_at_index(Variant& variant, const uint64_t index)
+void construct_variant_at_index(const Archive& ar, Variant& variant, const uint64_t index)
 {
     if constexpr (Index >= std::variant_size_v<Variant>) {
         throw std::bad_variant_access();
     } else if (Index == index) {
         using Type = std::variant_alternative_t<Index, Variant>;
         static_assert(std::is_default_constructible_v<Type>);
-        auto value = Type();
-        variant = std::move(value);
+        variant.template emplace<Index>(ar.make_value<Type>());
     } else {
-        return construct_variant_at_index<Variant, Index + 1>(variant, index);
+        return construct_variant_at_index<Variant, Index + 1>(ar, variant, index);
     }
 }
 
@@ -34,12 +33,12 @@ struct VariantDefaultSerializer {
     {
         if (ar.serializing()) {
             uint64_t index = variant.index();
-            ar.archive(index);
+            ar.archive_size(index);
             std::visit([&]<class T>(T& value) { ar.archive(value); }, variant);
         } else {
             uint64_t index = 0;
-            ar.archive(index);
-            detail::construct_variant_at_index<std::variant<Types...>>(variant, index);
+            ar.archive_size(index);
+            detail::construct_variant_at_index<std::variant<Types...>>(ar, variant, index);
             std::visit([&]<class T>(T& value) { ar.archive(value); }, variant);
         }
     }
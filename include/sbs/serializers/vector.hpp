@@ -4,6 +4,7 @@
 #include <sbs/sbs.hpp>
 
 #include <cstdint>
+#include <stdexcept>
 #include <vector>
 
 namespace sbs {
@@ -15,16 +16,32 @@ struct VectorSerializer {
     {
         if (ar.serializing()) {
             uint64_t size = vector.size();
-            ar.archive(size);
-            for (Type& item : vector) {
-                ar.archive<TypeSerializer>(item);
-            }
+            ar.archive_size(size);
+            archive_items(ar, vector);
         } else {
             vector.clear();
             uint64_t size = 0;
-            ar.archive(size);
-            vector.resize(size);
-            for (Type& item : vector) {
+            ar.archive_size(size);
+            if (size > vector.max_size()) {
+                throw std::runtime_error("Length exceeds the maximum");
+            }
+            while (vector.size() < size) {
+                const size_t begin = vector.size();
+                vector.resize(
+                    begin
+                    + ar.allocation_count(size - begin, sizeof(Type), fixed_serialized_size<TypeSerializer, Type>));
+                archive_items(ar, std::span<Type>(vector).subspan(begin));
+            }
+        }
+    }
+
+private:
+    static void archive_items(Archive& ar, const std::span<Type> items)
+    {
+        if constexpr (SpanSerializable<TypeSerializer, Type>) {
+            ar.archive_span(items);
+        } else {
+            for (Type& item : items) {
                 ar.archive<TypeSerializer>(item);
             }
         }
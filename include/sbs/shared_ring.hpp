@@ -0,0 +1,411 @@
+#ifndef SBS_SHARED_RING_HPP
+#define SBS_SHARED_RING_HPP
+
+#include <sbs/sbs.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace sbs {
+
+struct SharedRingOptions {
+    // Size of the ring's data in bytes, rounded up to a multiple of the page size. Messages may be larger than the
+    // ring, in which case the writer waits for the reader to consume the start of the message.
+    size_t capacity = 1024 * 1024;
+};
+
+namespace detail {
+
+// Lives in the first page of the shared memory. The head and tail count every byte ever written and consumed, so the
+// number of readable bytes is always `head - tail`. Each side has its own cache line so that publishing one does not
+// invalidate the other.
+struct SharedRingHeader {
+    static constexpr uint64_t expected_magic = 0x676e6972'5f736273;
+
+    uint64_t magic;
+    uint64_t capacity;
+    std::atomic<uint32_t> closed;
+    alignas(64) std::atomic<uint64_t> head;
+    // Incremented whenever the head moves while the reader waits, to wake it with a futex.
+    std::atomic<uint32_t> head_signal;
+    std::atomic<uint32_t> reader_waiting;
+    alignas(64) std::atomic<uint64_t> tail;
+    std::atomic<uint32_t> tail_signal;
+    std::atomic<uint32_t> writer_waiting;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free);
+
+// Waits become futex sleeps only after spinning for a while, since a message usually follows shortly when processes
+// exchange them back and forth. On a single hardware thread the other process cannot make progress while spinning.
+inline int shared_ring_spin_count()
+{
+    static const int spin_count = std::thread::hardware_concurrency() > 1 ? 4096 : 0;
+    return spin_count;
+}
+
+// Without futexes, which can only be waited on by other processes on Linux, waiting falls back to sleeping briefly.
+inline void shared_ring_sleep(std::atomic<uint32_t>& signal, const uint32_t value)
+{
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal), FUTEX_WAIT, value, nullptr, nullptr, 0);
+#else
+    static_cast<void>(signal);
+    static_cast<void>(value);
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+}
+
+inline void shared_ring_wake(std::atomic<uint32_t>& signal)
+{
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    static_cast<void>(signal);
+#endif
+}
+
+// The waiting flag is set before rechecking the condition and the other side checks it after publishing, all
+// sequentially consistent, so either the waiter sees the update or the other side sees the flag and wakes it.
+template <class Predicate>
+void shared_ring_wait(std::atomic<uint32_t>& signal, std::atomic<uint32_t>& waiting, Predicate ready)
+{
+    for (int spin = 0; spin < shared_ring_spin_count(); ++spin) {
+        if (ready()) {
+            return;
+        }
+    }
+    while (true) {
+        waiting.store(1);
+        const uint32_t value = signal.load();
+        if (ready()) {
+            break;
+        }
+        shared_ring_sleep(signal, value);
+    }
+    waiting.store(0, std::memory_order_relaxed);
+}
+
+inline void shared_ring_notify(std::atomic<uint32_t>& signal, std::atomic<uint32_t>& waiting)
+{
+    if (waiting.load() != 0) {
+        signal.fetch_add(1);
+        shared_ring_wake(signal);
+    }
+}
+
+}
+
+// A single-producer, single-consumer byte ring in POSIX shared memory for passing messages between processes on the
+// same host. One process creates the ring and the other opens it by name, then one writes with a `SharedRingWriter`
+// and the other reads with a `SharedRingReader`, so values are serialized directly into the ring and deserialized
+// directly out of it.
+//
+// The ring's data is mapped twice in a row, so every readable or writable range is contiguous in memory even when it
+// wraps around the end of the ring.
+class SharedRing {
+public:
+    // Creates a new ring, failing if one with the name exists. Names start with a slash, such as "/my_ring".
+    static SharedRing create(const std::string& name, const SharedRingOptions& options = { })
+    {
+        const int file = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (file == -1) {
+            throw std::runtime_error("Unable to create shared ring: " + name);
+        }
+        const size_t page_size = page_size_bytes();
+        const size_t capacity = std::max((options.capacity + page_size - 1) / page_size * page_size, page_size);
+        if (::ftruncate(file, static_cast<off_t>(page_size + capacity)) == -1) {
+            ::close(file);
+            ::shm_unlink(name.c_str());
+            throw std::runtime_error("Unable to create shared ring: " + name);
+        }
+        SharedRing ring;
+        try {
+            ring.map(file, capacity);
+        } catch (...) {
+            ::close(file);
+            ::shm_unlink(name.c_str());
+            throw;
+        }
+        ::close(file);
+        auto* header = new (ring.m_header) detail::SharedRingHeader { };
+        header->capacity = capacity;
+        header->magic = detail::SharedRingHeader::expected_magic;
+        return ring;
+    }
+
+    // Opens a ring created by another process.
+    static SharedRing open(const std::string& name)
+    {
+        const int file = ::shm_open(name.c_str(), O_RDWR, 0);
+        if (file == -1) {
+            throw std::runtime_error("Unable to open shared ring: " + name);
+        }
+        const size_t page_size = page_size_bytes();
+        void* header = ::mmap(nullptr, page_size, PROT_READ, MAP_SHARED, file, 0);
+        if (header == MAP_FAILED) {
+            ::close(file);
+            throw std::runtime_error("Unable to open shared ring: " + name);
+        }
+        const auto* ring_header = static_cast<const detail::SharedRingHeader*>(header);
+        const uint64_t magic = ring_header->magic;
+        const uint64_t capacity = ring_header->capacity;
+        ::munmap(header, page_size);
+        if (magic != detail::SharedRingHeader::expected_magic || capacity == 0 || capacity % page_size != 0) {
+            ::close(file);
+            throw std::runtime_error("Invalid shared ring: " + name);
+        }
+        SharedRing ring;
+        try {
+            ring.map(file, static_cast<size_t>(capacity));
+        } catch (...) {
+            ::close(file);
+            throw;
+        }
+        ::close(file);
+        return ring;
+    }
+
+    // Removes the ring's name. Processes that have it open keep using it until they close it.
+    static void remove(const std::string& name)
+    {
+        ::shm_unlink(name.c_str());
+    }
+
+    SharedRing(const SharedRing&) = delete;
+    SharedRing& operator=(const SharedRing&) = delete;
+
+    SharedRing(SharedRing&& other) noexcept
+        : m_mapping { std::exchange(other.m_mapping, nullptr) }
+        , m_mapping_size { std::exchange(other.m_mapping_size, 0) }
+        , m_header { std::exchange(other.m_header, nullptr) }
+        , m_data { std::exchange(other.m_data, nullptr) }
+        , m_capacity { std::exchange(other.m_capacity, 0) }
+    {
+    }
+
+    SharedRing& operator=(SharedRing&& other) noexcept
+    {
+        if (this != &other) {
+            unmap();
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+            m_mapping_size = std::exchange(other.m_mapping_size, 0);
+            m_header = std::exchange(other.m_header, nullptr);
+            m_data = std::exchange(other.m_data, nullptr);
+            m_capacity = std::exchange(other.m_capacity, 0);
+        }
+        return *this;
+    }
+
+    ~SharedRing()
+    {
+        unmap();
+    }
+
+    [[nodiscard]] size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+private:
+    friend class SharedRingWriter;
+    friend class SharedRingReader;
+
+    void* m_mapping { };
+    size_t m_mapping_size { };
+    detail::SharedRingHeader* m_header { };
+    std::byte* m_data { };
+    size_t m_capacity { };
+
+    SharedRing() = default;
+
+    static size_t page_size_bytes()
+    {
+        return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    }
+
+    // Reserves address space for the header page and two copies of the data, then maps the shared memory over the
+    // first two and the data again over the third.
+    void map(const int file, const size_t capacity)
+    {
+        const size_t page_size = page_size_bytes();
+        m_mapping_size = page_size + 2 * capacity;
+        m_mapping = ::mmap(nullptr, m_mapping_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (m_mapping == MAP_FAILED) {
+            m_mapping = nullptr;
+            throw std::runtime_error("Unable to map shared ring");
+        }
+        auto* base = static_cast<std::byte*>(m_mapping);
+        constexpr int protection = PROT_READ | PROT_WRITE;
+        const auto data_offset = static_cast<off_t>(page_size);
+        if (::mmap(base, page_size + capacity, protection, MAP_SHARED | MAP_FIXED, file, 0) == MAP_FAILED
+            || ::mmap(base + page_size + capacity, capacity, protection, MAP_SHARED | MAP_FIXED, file, data_offset)
+                == MAP_FAILED) {
+            unmap();
+            throw std::runtime_error("Unable to map shared ring");
+        }
+        m_header = reinterpret_cast<detail::SharedRingHeader*>(base);
+        m_data = base + page_size;
+        m_capacity = capacity;
+    }
+
+    void unmap()
+    {
+        if (m_mapping != nullptr) {
+            ::munmap(m_mapping, m_mapping_size);
+            m_mapping = nullptr;
+        }
+    }
+};
+
+// Writes into a shared ring. Written bytes become visible to the reader when committed, which the archive does at the
+// end of each serialization, so each serialized value is published as a whole. There must be only one writer per
+// ring at a time.
+class SharedRingWriter {
+public:
+    explicit SharedRingWriter(SharedRing& ring)
+        : m_ring { ring }
+        , m_head { ring.m_header->head.load(std::memory_order_relaxed) }
+    {
+    }
+
+    void write(std::span<const std::byte> bytes)
+    {
+        while (!bytes.empty()) {
+            const std::span<std::byte> buffer = prepare(1);
+            const size_t size = std::min(bytes.size(), buffer.size());
+            std::memcpy(buffer.data(), bytes.data(), size);
+            commit(size);
+            bytes = bytes.subspan(size);
+        }
+    }
+
+    // Waits until `size` bytes are free, or the whole ring if it is smaller, and returns all free bytes.
+    std::span<std::byte> prepare(const size_t size)
+    {
+        detail::SharedRingHeader& header = *m_ring.m_header;
+        const size_t required = std::min(size, m_ring.m_capacity);
+        if (free_size() < required) {
+            detail::shared_ring_wait(header.tail_signal, header.writer_waiting, [&] {
+                m_tail = header.tail.load();
+                return free_size() >= required;
+            });
+        }
+        return { m_ring.m_data + m_head % m_ring.m_capacity, free_size() };
+    }
+
+    void commit(const size_t size)
+    {
+        if (size == 0) {
+            return;
+        }
+        detail::SharedRingHeader& header = *m_ring.m_header;
+        m_head += size;
+        header.head.store(m_head);
+        detail::shared_ring_notify(header.head_signal, header.reader_waiting);
+    }
+
+    // Marks the end of the stream. Once the reader has consumed everything written, its reads return no data instead
+    // of waiting.
+    void close()
+    {
+        detail::SharedRingHeader& header = *m_ring.m_header;
+        header.closed.store(1);
+        header.head_signal.fetch_add(1);
+        detail::shared_ring_wake(header.head_signal);
+    }
+
+private:
+    SharedRing& m_ring;
+    uint64_t m_head;
+    uint64_t m_tail { m_ring.m_header->tail.load() };
+
+    [[nodiscard]] size_t free_size() const
+    {
+        return m_ring.m_capacity - static_cast<size_t>(m_head - m_tail);
+    }
+};
+
+// Reads from a shared ring. Reads wait for the writer, so deserializing a value returns once all of it has arrived.
+// There must be only one reader per ring at a time.
+class SharedRingReader {
+public:
+    explicit SharedRingReader(SharedRing& ring)
+        : m_ring { ring }
+        , m_tail { ring.m_header->tail.load(std::memory_order_relaxed) }
+    {
+    }
+
+    std::span<const std::byte> read(const size_t size)
+    {
+        const std::span<const std::byte> bytes = data(size);
+        const size_t read_size = std::min(size, bytes.size());
+        consume(read_size);
+        return bytes.first(read_size);
+    }
+
+    // Waits until `size` bytes are readable, or the whole ring if it is smaller, and returns all readable bytes. Fewer
+    // bytes are only returned once the writer has closed the ring.
+    std::span<const std::byte> data(const size_t size)
+    {
+        detail::SharedRingHeader& header = *m_ring.m_header;
+        const size_t required = std::min(size, m_ring.m_capacity);
+        if (readable_size() < required) {
+            detail::shared_ring_wait(header.head_signal, header.reader_waiting, [&] {
+                m_head = header.head.load();
+                return readable_size() >= required || header.closed.load() != 0;
+            });
+            m_head = header.head.load();
+        }
+        return { m_ring.m_data + m_tail % m_ring.m_capacity, readable_size() };
+    }
+
+    void consume(const size_t size)
+    {
+        if (size == 0) {
+            return;
+        }
+        detail::SharedRingHeader& header = *m_ring.m_header;
+        m_tail += size;
+        header.tail.store(m_tail);
+        detail::shared_ring_notify(header.tail_signal, header.writer_waiting);
+    }
+
+private:
+    SharedRing& m_ring;
+    uint64_t m_tail;
+    uint64_t m_head { m_ring.m_header->head.load() };
+
+    [[nodiscard]] size_t readable_size() const
+    {
+        return static_cast<size_t>(m_head - m_tail);
+    }
+};
+
+}
+
+#endif
+
+#endif // SBS_SHARED_RING_HPP
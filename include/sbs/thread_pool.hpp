@@ -0,0 +1,126 @@
+#ifndef SBS_THREAD_POOL_HPP
+#define SBS_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sbs {
+
+namespace detail {
+
+class ThreadPool {
+public:
+    explicit ThreadPool(const size_t thread_count)
+    {
+        m_threads.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; ++i) {
+            m_threads.emplace_back([this] { run(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queued tasks are run before the threads are joined.
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock { m_mutex };
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+        for (std::thread& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    // Whether the calling thread is a worker of any pool. Tasks that would wait on tasks of the same pool run their
+    // work directly instead, since waiting could take up every worker.
+    [[nodiscard]] static bool on_worker_thread()
+    {
+        return worker_thread();
+    }
+
+    template <class Function>
+    std::future<std::invoke_result_t<Function>> submit(Function function)
+    {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Function>()>>(std::move(function));
+        std::future<std::invoke_result_t<Function>> future = task->get_future();
+        {
+            std::lock_guard lock { m_mutex };
+            m_tasks.emplace_back([task = std::move(task)] { (*task)(); });
+        }
+        m_condition.notify_one();
+        return future;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stopping { };
+    std::vector<std::thread> m_threads;
+
+    static bool& worker_thread()
+    {
+        thread_local bool worker = false;
+        return worker;
+    }
+
+    void run()
+    {
+        worker_thread() = true;
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock { m_mutex };
+                m_condition.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+                if (m_tasks.empty()) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+};
+
+// Returns a pool with `threads` threads shared by every caller asking for that many, whose threads are started on first
+// use and live until the program exits, so that serializing does not start threads on every call.
+inline ThreadPool& shared_thread_pool(const size_t threads)
+{
+    static std::mutex mutex;
+    static std::map<size_t, std::unique_ptr<ThreadPool>> pools;
+    std::lock_guard lock { mutex };
+    std::unique_ptr<ThreadPool>& pool = pools[threads];
+    if (pool == nullptr) {
+        pool = std::make_unique<ThreadPool>(threads);
+    }
+    return *pool;
+}
+
+inline size_t resolve_thread_count(const size_t threads)
+{
+    if (threads != 0) {
+        return threads;
+    }
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+}
+
+}
+
+#endif // SBS_THREAD_POOL_HPP
@@ -6,8 +6,20 @@
 
 #include "test_file.hpp"
 
+#include <sbs/async_file.hpp>
+#include <sbs/checksum.hpp>
+#include <sbs/chunks.hpp>
+#include <sbs/compression.hpp>
+#include <sbs/context.hpp>
+#include <sbs/fd_stream.hpp>
+#include <sbs/incremental.hpp>
+#include <sbs/mapped_file.hpp>
 #include <sbs/sbs.hpp>
+#include <sbs/scatter_gather.hpp>
+#include <sbs/shared_ring.hpp>
 
+#include <sbs/serializers/array.hpp>
+#include <sbs/serializers/map.hpp>
 #include <sbs/serializers/string.hpp>
 #include <sbs/serializers/vector.hpp>
 
@@ -15,6 +27,10 @@
 #include <bit>
 #include <cmath>
 #include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <thread>
 #include <vector>
 
 inline void assert_bytes_equal(const std::span<const std::byte> bytes, const std::initializer_list<uint8_t>& expected)
@@ -584,5 +600,1494 @@ inline void serialize_using_file()
         TEST_ASSERT(s_in == s_out);
     }
 
+    test_section("serialize_to_file buffer sizes");
+    {
+        for (const size_t buffer_size : { 0, 1, 5, 64 }) {
+            sbs::serialize_to_file(path, s_in, std::endian::big, sbs::FileWriterOptions { .buffer_size = buffer_size });
+            Struct s_out { };
+            sbs::deserialize_from_file(path, s_out, std::endian::big);
+            TEST_ASSERT(s_in == s_out);
+            TEST_ASSERT(std::filesystem::file_size(path) == sbs::serialize_to_vector(s_in).size());
+        }
+    }
+
+    test_section("deserialize_from_file buffer sizes");
+    {
+        sbs::serialize_to_file(path, s_in);
+        for (const size_t buffer_size : { 0, 1, 5, 64 }) {
+            Struct s_out { };
+            sbs::deserialize_from_file(path, s_out, std::endian::little, { .buffer_size = buffer_size });
+            TEST_ASSERT(s_in == s_out);
+        }
+    }
+
+    test_section("direct I/O");
+    {
+        for (const size_t size : { 0, 1, 4095, 4096, 4097, 3 * 4096 + 17, 1024 * 1024 + 5 }) {
+            std::vector<uint8_t> bytes_in(size);
+            for (size_t i = 0; i < size; ++i) {
+                bytes_in[i] = static_cast<uint8_t>(i * 31 + 7);
+            }
+            const std::vector<std::byte> expected = sbs::serialize_to_vector(bytes_in);
+            for (const size_t buffer_size : { 1, 4096, 10000, 64 * 1024 }) {
+                sbs::serialize_to_file(
+                    path,
+                    bytes_in,
+                    { },
+                    { .buffer_size = buffer_size, .direct_io = true, .preallocate_size = expected.size() / 2 + 1 });
+                TEST_ASSERT(std::filesystem::file_size(path) == expected.size());
+                std::vector<uint8_t> bytes_out;
+                sbs::deserialize_from_file(path, bytes_out, { }, { .buffer_size = buffer_size, .direct_io = true });
+                TEST_ASSERT(bytes_in == bytes_out);
+            }
+        }
+    }
+
+    test_section("direct I/O flush");
+    {
+        std::vector<std::byte> bytes(10000);
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            bytes[i] = static_cast<std::byte>(i);
+        }
+        {
+            sbs::FileWriter writer { path, { .buffer_size = 4096, .direct_io = true, .preallocate_size = 1 << 20 } };
+            writer.write(std::span(bytes).first(5000));
+            writer.flush();
+            TEST_ASSERT(std::filesystem::file_size(path) == 5000);
+            writer.write(std::span(bytes).subspan(5000, 100));
+            writer.flush();
+            TEST_ASSERT(std::filesystem::file_size(path) == 5100);
+            writer.write(std::span(bytes).subspan(5100));
+        }
+        TEST_ASSERT(std::filesystem::file_size(path) == bytes.size());
+        sbs::FileReader reader { path, { .buffer_size = 1, .direct_io = true } };
+        const std::span<const std::byte> first = reader.read(5001);
+        TEST_ASSERT(std::ranges::equal(first, std::span(bytes).first(5001)));
+        const std::span<const std::byte> rest = reader.read(bytes.size());
+        TEST_ASSERT(std::ranges::equal(rest, std::span(bytes).subspan(5001)));
+    }
+
+    test_section("deserialize_from_mapped_file");
+    {
+        sbs::serialize_to_file(path, s_in);
+        Struct s_out { };
+        sbs::deserialize_from_mapped_file(path, s_out, std::endian::little, { .will_need = true, .huge_pages = true });
+        TEST_ASSERT(s_in == s_out);
+    }
+
+    test_section("mapped file reuse");
+    {
+        {
+            sbs::FileWriter writer { path };
+            sbs::serialize_using_writer(s_in, writer);
+            sbs::serialize_using_writer(s_in, writer);
+        }
+        const sbs::MappedFile file { path };
+        TEST_ASSERT(file.bytes().size() == 2 * sbs::serialize_to_vector(s_in).size());
+        sbs::SpanReader reader { file.bytes() };
+        Struct s_out_1 { };
+        sbs::deserialize_using_reader(s_out_1, reader);
+        Struct s_out_2 { };
+        sbs::deserialize_using_reader(s_out_2, reader);
+        TEST_ASSERT(s_in == s_out_1);
+        TEST_ASSERT(s_in == s_out_2);
+        TEST_ASSERT(reader.remaining().empty());
+    }
+
+    test_section("deserialize_from_file insufficient data");
+    {
+        std::vector<std::byte> bytes = sbs::serialize_to_vector(s_in);
+        bytes.pop_back();
+        {
+            sbs::FileWriter writer { path };
+            writer.write(bytes);
+        }
+        bool thrown = false;
+        try {
+            Struct s_out { };
+            sbs::deserialize_from_file(path, s_out);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+    }
+
+    std::filesystem::remove(path);
+}
+class ChunkedWriter {
+public:
+    std::vector<std::byte> bytes;
+
+    void write(const std::span<const std::byte> data)
+    {
+        bytes.insert(bytes.end(), data.begin(), data.end());
+    }
+
+    std::span<std::byte> prepare(const size_t size)
+    {
+        m_buffer.resize(std::max(size, chunk_size));
+        return m_buffer;
+    }
+
+    void commit(const size_t size)
+    {
+        write(std::span(m_buffer).first(size));
+    }
+
+private:
+    static constexpr size_t chunk_size = 3;
+    std::vector<std::byte> m_buffer;
+};
+
+class ChunkedReader {
+public:
+    explicit ChunkedReader(const std::span<const std::byte> bytes)
+        : m_bytes { bytes }
+    {
+    }
+
+    std::span<const std::byte> read(const size_t size)
+    {
+        const std::span<const std::byte> bytes = m_bytes.first(std::min(size, m_bytes.size()));
+        m_bytes = m_bytes.subspan(bytes.size());
+        return bytes;
+    }
+
+    std::span<const std::byte> data(const size_t size) const
+    {
+        return m_bytes.first(std::min(std::max(size, chunk_size), m_bytes.size()));
+    }
+
+    void consume(const size_t size)
+    {
+        m_bytes = m_bytes.subspan(size);
+    }
+
+    [[nodiscard]] size_t remaining() const
+    {
+        return m_bytes.size();
+    }
+
+private:
+    static constexpr size_t chunk_size = 3;
+    std::span<const std::byte> m_bytes;
+};
+
+inline void serialize_using_writer_and_reader()
+{
+    test_case("serialize using writer and reader");
+
+    struct Struct {
+        uint8_t uint8;
+        double d;
+        std::string str;
+        std::vector<int32_t> numbers;
+
+        void serialize(sbs::Archive& ar)
+        {
+            ar.archive(uint8);
+            ar.archive(d);
+            ar.archive(str);
+            ar.archive(numbers);
+        }
+
+        bool operator==(const Struct& other) const
+        {
+            return uint8 == other.uint8 && d == other.d && str == other.str && numbers == other.numbers;
+        }
+    };
+
+    static_assert(sbs::BufferedWriter<ChunkedWriter>);
+    static_assert(sbs::BufferedReader<ChunkedReader>);
+    static_assert(sbs::BufferedWriter<sbs::VectorWriter>);
+    static_assert(sbs::BufferedReader<sbs::SpanReader>);
+    static_assert(sbs::Writer<sbs::CallbackWriter> && !sbs::BufferedWriter<sbs::CallbackWriter>);
+    static_assert(sbs::Reader<sbs::CallbackReader> && !sbs::BufferedReader<sbs::CallbackReader>);
+
+    Struct s_in { .uint8 = 37, .d = -1.5, .str = "Hello World!", .numbers = { -8, -6, -4, -2, 0, 2, 4, 6, 8 } };
+    const std::vector<std::byte> expected = sbs::serialize_to_vector(s_in);
+
+    test_section("buffered writer");
+    {
+        ChunkedWriter writer;
+        sbs::serialize_using_writer(s_in, writer);
+        TEST_ASSERT(writer.bytes == expected);
+    }
+
+    test_section("buffered reader");
+    {
+        ChunkedReader reader { expected };
+        Struct s_out { };
+        sbs::deserialize_using_reader(s_out, reader);
+        TEST_ASSERT(s_in == s_out);
+        TEST_ASSERT(reader.remaining() == 0);
+    }
+
+    test_section("buffered reader insufficient data");
+    {
+        ChunkedReader reader { std::span(expected).first(expected.size() - 1) };
+        Struct s_out { };
+        bool thrown = false;
+        try {
+            sbs::deserialize_using_reader(s_out, reader);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+    }
+
+    test_section("vector writer appends");
+    {
+        std::vector<std::byte> bytes { std::byte { 0xFF } };
+        {
+            sbs::VectorWriter writer { bytes };
+            sbs::serialize_using_writer(s_in, writer);
+        }
+        TEST_ASSERT(bytes.size() == expected.size() + 1);
+        TEST_ASSERT(std::equal(expected.begin(), expected.end(), bytes.begin() + 1));
+    }
+
+    test_section("callback");
+    {
+        std::vector<std::byte> bytes;
+        sbs::serialize_using_callback(s_in, [&bytes](const std::span<const std::byte> data) {
+            bytes.insert(bytes.end(), data.begin(), data.end());
+        });
+        TEST_ASSERT(bytes == expected);
+        std::span<const std::byte> remaining = bytes;
+        Struct s_out { };
+        sbs::deserialize_using_callback(s_out, [&remaining](const size_t size) {
+            const std::span<const std::byte> data = remaining.first(size);
+            remaining = remaining.subspan(size);
+            return data;
+        });
+        TEST_ASSERT(s_in == s_out);
+    }
+}
+
+inline void serialize_counting()
+{
+    test_case("serialize counting");
+
+    struct Struct {
+        uint8_t uint8;
+        double d;
+        std::string str;
+        std::vector<int32_t> numbers;
+
+        void serialize(sbs::Archive& ar)
+        {
+            ar.archive(uint8);
+            ar.archive(d);
+            ar.archive(str);
+            ar.archive(numbers);
+        }
+
+        bool operator==(const Struct& other) const
+        {
+            return uint8 == other.uint8 && d == other.d && str == other.str && numbers == other.numbers;
+        }
+    };
+
+    Struct s_in { .uint8 = 37, .d = -1.5, .str = "Hello World!", .numbers = { -8, -6, -4, -2, 0, 2, 4, 6, 8 } };
+
+    test_section("serialized_size");
+    {
+        TEST_ASSERT(sbs::serialized_size(s_in) == 1 + 8 + 8 + 12 + 8 + 9 * 4);
+        TEST_ASSERT(sbs::serialized_size(s_in) == sbs::serialize_to_vector(s_in).size());
+        uint16_t uint16 = 7;
+        TEST_ASSERT(sbs::serialized_size(uint16) == 2);
+    }
+
+    test_section("presized serialize_to_vector");
+    {
+        const std::vector<std::byte> bytes = sbs::serialize_to_vector(s_in, std::endian::big, { .presize = true });
+        TEST_ASSERT(bytes == sbs::serialize_to_vector(s_in, std::endian::big));
+        TEST_ASSERT(bytes.capacity() == bytes.size());
+        Struct s_out { };
+        sbs::deserialize_from_span(bytes, s_out, std::endian::big);
+        TEST_ASSERT(s_in == s_out);
+    }
+}
+
+template <template <class> class SerializeType, class Type>
+concept serializer_accepts = requires { typename SerializeType<Type>; };
+
+static_assert(
+    serializer_accepts<sbs::VarintSerializer, uint8_t> && serializer_accepts<sbs::VarintSerializer, uint64_t>);
+static_assert(!serializer_accepts<sbs::VarintSerializer, bool> && !serializer_accepts<sbs::VarintSerializer, char8_t>);
+static_assert(!serializer_accepts<sbs::VarintSerializer, int32_t>);
+static_assert(serializer_accepts<sbs::ZigZagSerializer, int8_t> && !serializer_accepts<sbs::ZigZagSerializer, char>);
+
+inline void serialize_varint()
+{
+    test_case("serialize varint");
+
+    test_section("encoding");
+    {
+        uint64_t uint64 = 0;
+        assert_bytes_equal(sbs::serialize_to_vector<sbs::VarintSerializer<uint64_t>>(uint64), { 0x00 });
+        uint64 = 127;
+        assert_bytes_equal(sbs::serialize_to_vector<sbs::VarintSerializer<uint64_t>>(uint64), { 0x7f });
+        uint64 = 300;
+        assert_bytes_equal(sbs::serialize_to_vector<sbs::VarintSerializer<uint64_t>>(uint64), { 0xac, 0x02 });
+        uint64 = std::numeric_limits<uint64_t>::max();
+        assert_bytes_equal(
+            sbs::serialize_to_vector<sbs::VarintSerializer<uint64_t>>(uint64),
+            { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01 });
+        int32_t int32 = -1;
+        assert_bytes_equal(sbs::serialize_to_vector<sbs::ZigZagSerializer<int32_t>>(int32), { 0x01 });
+        int32 = 1;
+        assert_bytes_equal(sbs::serialize_to_vector<sbs::ZigZagSerializer<int32_t>>(int32), { 0x02 });
+    }
+
+    test_section("round trip");
+    {
+        std::vector<uint64_t> values;
+        for (int shift = 0; shift < 64; ++shift) {
+            const uint64_t bit = uint64_t(1) << shift;
+            values.insert(values.end(), { bit - 1, bit, bit + 1 });
+        }
+        values.push_back(std::numeric_limits<uint64_t>::max());
+        for (uint64_t value_in : values) {
+            const std::vector<std::byte> bytes = sbs::serialize_to_vector<sbs::VarintSerializer<uint64_t>>(value_in);
+            TEST_ASSERT(sbs::serialized_size<sbs::VarintSerializer<uint64_t>>(value_in) == bytes.size());
+            uint64_t value_out = 0;
+            sbs::deserialize_from_span<sbs::VarintSerializer<uint64_t>>(bytes, value_out);
+            TEST_ASSERT(value_in == value_out);
+            value_out = 0;
+            ChunkedReader reader { bytes };
+            sbs::deserialize_using_reader<sbs::VarintSerializer<uint64_t>>(value_out, reader);
+            TEST_ASSERT(value_in == value_out);
+        }
+        for (int64_t value_in : { int64_t(0),
+                                  int64_t(-64),
+                                  int64_t(64),
+                                  std::numeric_limits<int64_t>::min(),
+                                  std::numeric_limits<int64_t>::max() }) {
+            const std::vector<std::byte> bytes = sbs::serialize_to_vector<sbs::ZigZagSerializer<int64_t>>(value_in);
+            int64_t value_out = 0;
+            sbs::deserialize_from_span<sbs::ZigZagSerializer<int64_t>>(bytes, value_out);
+            TEST_ASSERT(value_in == value_out);
+        }
+    }
+
+    test_section("varint sizes");
+    {
+        sbs::ArchiveOptions options;
+        options.size_encoding = sbs::SizeEncoding::varint;
+        std::vector<std::string> strings_in { "", "a", std::string(200, 'b') };
+        const std::vector<std::byte> bytes = sbs::serialize_to_vector(strings_in, options);
+        TEST_ASSERT(bytes.size() == 1 + 1 + (1 + 1) + (2 + 200));
+        TEST_ASSERT(sbs::serialized_size(strings_in, options) == bytes.size());
+        std::vector<std::string> strings_out;
+        sbs::deserialize_from_span(bytes, strings_out, options);
+        TEST_ASSERT(strings_in == strings_out);
+    }
+
+    test_section("invalid varint");
+    {
+        const auto throws = [](auto&& function) {
+            try {
+                function();
+            } catch (const std::runtime_error&) {
+                return true;
+            }
+            return false;
+        };
+        const std::vector<std::byte> too_long(11, std::byte { 0x80 });
+        uint64_t uint64 = 0;
+        TEST_ASSERT(throws([&] { sbs::deserialize_from_span<sbs::VarintSerializer<uint64_t>>(too_long, uint64); }));
+        std::vector<std::byte> overflow(9, std::byte { 0xff });
+        overflow.push_back(std::byte { 0x02 });
+        TEST_ASSERT(throws([&] { sbs::deserialize_from_span<sbs::VarintSerializer<uint64_t>>(overflow, uint64); }));
+        const std::vector<std::byte> truncated { std::byte { 0x80 } };
+        TEST_ASSERT(throws([&] { sbs::deserialize_from_span<sbs::VarintSerializer<uint64_t>>(truncated, uint64); }));
+        const std::vector<std::byte> too_large { std::byte { 0x80 }, std::byte { 0x02 } };
+        uint8_t uint8 = 0;
+        TEST_ASSERT(throws([&] { sbs::deserialize_from_span<sbs::VarintSerializer<uint8_t>>(too_large, uint8); }));
+    }
+}
+
+// Stores blocks as is to check that custom codecs can be plugged in.
+struct IdentityCodec {
+    [[nodiscard]] size_t max_compressed_size(const size_t size) const
+    {
+        return size;
+    }
+
+    size_t compress(const std::span<const std::byte> input, const std::span<std::byte> output) const
+    {
+        std::memcpy(output.data(), input.data(), input.size());
+        return input.size();
+    }
+
+    void decompress(const std::span<const std::byte> input, const std::span<std::byte> output) const
+    {
+        std::memcpy(output.data(), input.data(), input.size());
+    }
+};
+
+inline void serialize_compressed()
+{
+    test_case("serialize compressed");
+
+    struct Snapshot {
+        std::string name;
+        std::vector<uint32_t> counters;
+        std::vector<uint64_t> noise;
+
+        void serialize(sbs::Archive& ar)
+        {
+            ar.archive(name);
+            ar.archive(counters);
+            ar.archive(noise);
+        }
+
+        bool operator==(const Snapshot& other) const
+        {
+            return name == other.name && counters == other.counters && noise == other.noise;
+        }
+    };
+
+    Snapshot s_in { .name = "snapshot", .counters = { }, .noise = { } };
+    for (uint32_t i = 0; i < 100000; ++i) {
+        s_in.counters.push_back(i % 97);
+    }
+    uint64_t state = 88172645463325252ULL;
+    for (int i = 0; i < 5000; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        s_in.noise.push_back(state);
+    }
+    const size_t uncompressed_size = sbs::serialized_size(s_in);
+
+    test_section("codec round trip");
+    {
+        const sbs::LzCodec codec;
+        for (const size_t size : { size_t(0), size_t(3), size_t(4), size_t(100), size_t(70000) }) {
+            std::vector<std::byte> input(size);
+            for (size_t i = 0; i < size; ++i) {
+                input[i] = static_cast<std::byte>(i % 7 == 0 ? i / 7 : i % 3);
+            }
+            std::vector<std::byte> compressed(codec.max_compressed_size(size));
+            compressed.resize(codec.compress(input, compressed));
+            std::vector<std::byte> output(size);
+            codec.decompress(compressed, output);
+            TEST_ASSERT(input == output);
+        }
+
+        // Incompressible input makes the compressor skip ahead in steps that grow up to the end of the input.
+        for (const size_t size : { size_t(5000), size_t(70001) }) {
+            std::vector<std::byte> input(size);
+            uint32_t state = 1;
+            for (std::byte& byte : input) {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                byte = static_cast<std::byte>(state);
+            }
+            std::vector<std::byte> compressed(codec.max_compressed_size(size));
+            compressed.resize(codec.compress(input, compressed));
+            std::vector<std::byte> output(size);
+            codec.decompress(compressed, output);
+            TEST_ASSERT(input == output);
+        }
+    }
+
+    test_section("vector and span");
+    {
+        for (const size_t threads : { size_t(1), size_t(4) }) {
+            const sbs::CompressionOptions options { .block_size = 64 * 1024, .threads = threads };
+            const std::vector<std::byte> bytes = sbs::serialize_compressed_to_vector(s_in, { }, options);
+            TEST_ASSERT(bytes.size() < uncompressed_size / 4);
+            Snapshot s_out { };
+            sbs::deserialize_compressed_from_span(bytes, s_out, { }, options);
+            TEST_ASSERT(s_in == s_out);
+        }
+    }
+
+    test_section("small blocks and chunked io");
+    {
+        const sbs::CompressionOptions options { .block_size = 5, .threads = 3 };
+        ChunkedWriter chunked_writer;
+        {
+            sbs::CompressedWriter writer { chunked_writer, options };
+            sbs::serialize_using_writer(s_in, writer, std::endian::big);
+            writer.finish();
+        }
+        chunked_writer.bytes.push_back(std::byte { 42 });
+        ChunkedReader chunked_reader { chunked_writer.bytes };
+        Snapshot s_out { };
+        {
+            sbs::CompressedReader reader { chunked_reader, options };
+            sbs::deserialize_using_reader(s_out, reader, std::endian::big);
+        }
+        TEST_ASSERT(s_in == s_out);
+        TEST_ASSERT(chunked_reader.remaining() == 1);
+
+        // A reader destroyed while blocks it read ahead are still being decompressed waits for them.
+        ChunkedReader partial_reader { chunked_writer.bytes };
+        {
+            sbs::CompressedReader reader { partial_reader, options };
+            TEST_ASSERT(reader.read(1).size() == 1);
+        }
+    }
+
+    test_section("file");
+    {
+        const std::filesystem::path path = "tests/temp/compressed.bin";
+        sbs::serialize_compressed_to_file(path, s_in);
+        TEST_ASSERT(std::filesystem::file_size(path) < uncompressed_size / 4);
+        Snapshot s_out { };
+        sbs::deserialize_compressed_from_file(path, s_out);
+        TEST_ASSERT(s_in == s_out);
+        std::filesystem::remove(path);
+    }
+
+    test_section("custom codec");
+    {
+        const std::vector<std::byte> bytes
+            = sbs::serialize_compressed_to_vector(s_in, { }, { .threads = 2 }, IdentityCodec { });
+        TEST_ASSERT(bytes.size() > uncompressed_size);
+        Snapshot s_out { };
+        sbs::deserialize_compressed_from_span(bytes, s_out, { }, { .threads = 2 }, IdentityCodec { });
+        TEST_ASSERT(s_in == s_out);
+    }
+
+    test_section("corrupt data");
+    {
+        const auto throws = [](auto&& function) {
+            try {
+                function();
+            } catch (const std::runtime_error&) {
+                return true;
+            }
+            return false;
+        };
+        const std::vector<std::byte> bytes = sbs::serialize_compressed_to_vector(s_in, { }, { .threads = 1 });
+        Snapshot s_out { };
+        const std::span<const std::byte> truncated = std::span(bytes).first(bytes.size() / 2);
+        TEST_ASSERT(throws([&] { sbs::deserialize_compressed_from_span(truncated, s_out); }));
+        std::vector<std::byte> corrupt = bytes;
+        for (size_t i = 100; i < corrupt.size(); i += 50) {
+            corrupt[i] = ~corrupt[i];
+        }
+        TEST_ASSERT(throws([&] { sbs::deserialize_compressed_from_span(corrupt, s_out); }));
+    }
+}
+
+inline void serialize_checksummed()
+{
+    test_case("serialize checksummed");
+
+    struct Struct {
+        std::string str;
+        std::vector<int32_t> numbers;
+
+        void serialize(sbs::Archive& ar)
+        {
+            ar.archive(str);
+            ar.archive(numbers);
+        }
+
+        bool operator==(const Struct& other) const
+        {
+            return str == other.str && numbers == other.numbers;
+        }
+    };
+
+    Struct s_in { .str = "Hello World!", .numbers = { } };
+    for (int32_t i = 0; i < 1000; ++i) {
+        s_in.numbers.push_back(i * i);
+    }
+
+    const auto throws = [](auto&& function) {
+        try {
+            function();
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+
+    test_section("crc32c");
+    {
+        const std::string check = "123456789";
+        const std::span<const std::byte> bytes = std::as_bytes(std::span(check));
+        sbs::Crc32c crc;
+        crc.update(bytes);
+        TEST_ASSERT(crc.value() == 0xe3069283);
+        TEST_ASSERT(~sbs::detail::crc32c_software(0xffffffff, bytes) == 0xe3069283);
+        std::vector<std::byte> long_bytes(1000);
+        for (size_t i = 0; i < long_bytes.size(); ++i) {
+            long_bytes[i] = static_cast<std::byte>(i * 31);
+        }
+        sbs::Crc32c pieces;
+        pieces.update(std::span(long_bytes).first(3));
+        pieces.update(std::span(long_bytes).subspan(3));
+        TEST_ASSERT(pieces.value() == ~sbs::detail::crc32c_software(0xffffffff, long_bytes));
+    }
+
+    test_section("vector and span");
+    {
+        const std::vector<std::byte> bytes = sbs::serialize_checksummed_to_vector(s_in);
+        TEST_ASSERT(bytes.size() == sbs::serialized_size(s_in) + sbs::checksum_size);
+        Struct s_out { };
+        sbs::deserialize_checksummed_from_span(bytes, s_out);
+        TEST_ASSERT(s_in == s_out);
+    }
+
+    test_section("chunked io");
+    {
+        ChunkedWriter chunked_writer;
+        sbs::ChecksumWriter writer { chunked_writer };
+        sbs::serialize_using_writer(s_in, writer, std::endian::big);
+        writer.write_checksum();
+        ChunkedReader chunked_reader { chunked_writer.bytes };
+        sbs::ChecksumReader reader { chunked_reader };
+        Struct s_out { };
+        sbs::deserialize_using_reader(s_out, reader, std::endian::big);
+        reader.verify_checksum();
+        TEST_ASSERT(s_in == s_out);
+        TEST_ASSERT(reader.checksum() == writer.checksum());
+    }
+
+    test_section("file");
+    {
+        const std::filesystem::path path = "tests/temp/checksummed.bin";
+        sbs::serialize_checksummed_to_file(path, s_in);
+        Struct s_out { };
+        sbs::deserialize_checksummed_from_file(path, s_out);
+        TEST_ASSERT(s_in == s_out);
+        std::filesystem::remove(path);
+    }
+
+    test_section("corruption");
+    {
+        std::vector<std::byte> bytes = sbs::serialize_checksummed_to_vector(s_in);
+        bytes[100] ^= std::byte { 0x10 };
+        Struct s_out { };
+        TEST_ASSERT(throws([&] { sbs::deserialize_checksummed_from_span(bytes, s_out); }));
+        bytes[100] ^= std::byte { 0x10 };
+        bytes.pop_back();
+        TEST_ASSERT(throws([&] { sbs::deserialize_checksummed_from_span(bytes, s_out); }));
+    }
+}
+
+inline void serialize_chunks()
+{
+    test_case("serialize chunks");
+
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        values.push_back(i * 7);
+    }
+    const std::vector<std::byte> expected = sbs::serialize_to_vector(values, std::endian::big);
+
+    test_section("chunks");
+    {
+        for (const size_t chunk_size : { size_t(1), size_t(7), size_t(4096), size_t(1000000) }) {
+            std::vector<std::byte> bytes;
+            size_t chunk_count = 0;
+            for (const std::span<const std::byte> chunk : sbs::serialize_chunks(values, chunk_size, std::endian::big)) {
+                TEST_ASSERT(chunk.size() == std::min(chunk_size, expected.size() - bytes.size()));
+                bytes.insert(bytes.end(), chunk.begin(), chunk.end());
+                ++chunk_count;
+            }
+            TEST_ASSERT(bytes == expected);
+            TEST_ASSERT(chunk_count == (expected.size() + chunk_size - 1) / chunk_size);
+        }
+    }
+
+    test_section("two buffers");
+    {
+        // The producer and the consumer swap the same two buffers.
+        std::vector<const std::byte*> buffers;
+        for (const std::span<const std::byte> chunk : sbs::serialize_chunks(values, 16)) {
+            if (std::ranges::find(buffers, chunk.data()) == buffers.end()) {
+                buffers.push_back(chunk.data());
+            }
+        }
+        TEST_ASSERT(buffers.size() == 2);
+    }
+
+    test_section("stop early");
+    {
+        sbs::ChunkGenerator chunks = sbs::serialize_chunks(values, 16);
+        TEST_ASSERT(chunks.next().size() == 16);
+        TEST_ASSERT(chunks.next().size() == 16);
+    }
+
+    test_section("exception");
+    {
+        struct Throwing {
+            void serialize(sbs::Archive& ar)
+            {
+                uint64_t value = 1;
+                ar.archive(value);
+                throw std::runtime_error("Serialization failed");
+            }
+        };
+        Throwing throwing;
+        sbs::ChunkGenerator chunks = sbs::serialize_chunks(throwing, 4);
+        TEST_ASSERT(chunks.next().size() == 4);
+        bool thrown = false;
+        try {
+            static_cast<void>(chunks.next());
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+    }
+}
+
+inline void deserialize_incrementally()
+{
+    test_case("deserialize incrementally");
+
+    struct Message {
+        uint16_t id;
+        std::string text;
+        std::vector<uint32_t> values;
+
+        void serialize(sbs::Archive& ar)
+        {
+            ar.archive(id);
+            ar.archive(text);
+            ar.archive(values);
+        }
+
+        bool operator==(const Message& other) const
+        {
+            return id == other.id && text == other.text && values == other.values;
+        }
+    };
+
+    Message first { .id = 1, .text = "first", .values = { 1, 2, 3 } };
+    Message second { .id = 2, .text = "second", .values = { } };
+    for (uint32_t i = 0; i < 1000; ++i) {
+        second.values.push_back(i);
+    }
+    std::vector<std::byte> bytes = sbs::serialize_to_vector(first);
+    const std::vector<std::byte> second_bytes = sbs::serialize_to_vector(second);
+    bytes.insert(bytes.end(), second_bytes.begin(), second_bytes.end());
+
+    test_section("byte by byte");
+    {
+        sbs::IncrementalDeserializer<Message> deserializer;
+        size_t fed = 0;
+        while (deserializer.feed(std::span(bytes).subspan(fed, 1)) == sbs::IncrementalStatus::need_more_data) {
+            ++fed;
+        }
+        TEST_ASSERT(fed + 1 == bytes.size() - second_bytes.size());
+        TEST_ASSERT(deserializer.value() == first);
+        TEST_ASSERT(deserializer.remaining().empty());
+    }
+
+    test_section("fragments and leftover");
+    {
+        sbs::IncrementalDeserializer<Message> deserializer;
+        const std::span<const std::byte> input = bytes;
+        TEST_ASSERT(deserializer.feed(input.first(5)) == sbs::IncrementalStatus::need_more_data);
+        TEST_ASSERT(deserializer.bytes_needed() > 0);
+        TEST_ASSERT(deserializer.feed(input.subspan(5, 100)) == sbs::IncrementalStatus::complete);
+        TEST_ASSERT(deserializer.value() == first);
+        TEST_ASSERT(deserializer.remaining().size() == 105 - (bytes.size() - second_bytes.size()));
+        deserializer.reset();
+        TEST_ASSERT(deserializer.feed({ }) == sbs::IncrementalStatus::need_more_data);
+        // The values arrive in one large read so nothing is attempted until all of them are buffered.
+        TEST_ASSERT(deserializer.bytes_needed() == 1000 * sizeof(uint32_t) - (105 - bytes.size() + second_bytes.size())
+                        + sizeof(uint16_t) + sizeof(uint64_t) + second.text.size() + sizeof(uint64_t));
+        TEST_ASSERT(deserializer.feed(input.subspan(105)) == sbs::IncrementalStatus::complete);
+        TEST_ASSERT(deserializer.value() == second);
+        TEST_ASSERT(deserializer.remaining().empty());
+    }
+
+    test_section("invalid data");
+    {
+        sbs::IncrementalDeserializer<std::string> deserializer;
+        std::vector<std::byte> invalid(sizeof(uint64_t), std::byte { 0xff });
+        bool thrown = false;
+        try {
+            static_cast<void>(deserializer.feed(invalid));
+        } catch (const std::exception&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+    }
+}
+
+inline void serialize_with_context()
+{
+    test_case("serialize with context");
+
+    std::vector<std::string> first { "one", "two", "three" };
+    std::string second(1000, 'x');
+
+    test_section("context");
+    {
+        sbs::SerializeContext context;
+        const std::span<const std::byte> first_bytes = context.serialize(first, std::endian::big);
+        TEST_ASSERT(std::ranges::equal(first_bytes, sbs::serialize_to_vector(first, std::endian::big)));
+        const std::span<const std::byte> second_bytes = context.serialize(second);
+        TEST_ASSERT(std::ranges::equal(second_bytes, sbs::serialize_to_vector(second)));
+        TEST_ASSERT(context.bytes().size() == first_bytes.size() + second_bytes.size());
+        TEST_ASSERT(context.bytes().data() == second_bytes.data() - first_bytes.size());
+
+        const size_t capacity = context.capacity();
+        const std::byte* data = context.bytes().data();
+        context.reset();
+        TEST_ASSERT(context.bytes().empty());
+        TEST_ASSERT(context.capacity() == capacity);
+        TEST_ASSERT(context.serialize(second).data() == data);
+
+        struct Throwing {
+            void serialize(sbs::Archive& ar)
+            {
+                uint64_t value = 1;
+                ar.archive(value);
+                throw std::runtime_error("Throwing");
+            }
+        };
+        Throwing throwing;
+        bool thrown = false;
+        try {
+            context.serialize(throwing);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+        TEST_ASSERT(context.bytes().size() == sbs::serialize_to_vector(second).size());
+
+        context.reset();
+        context.shrink_to_fit();
+        TEST_ASSERT(context.capacity() == 0);
+    }
+
+    test_section("pool");
+    {
+        const sbs::SerializeContext* pooled_context = nullptr;
+        {
+            const sbs::PooledSerializeContext context = sbs::acquire_serialize_context();
+            pooled_context = &*context;
+            context->serialize(first);
+            const sbs::PooledSerializeContext nested = sbs::acquire_serialize_context();
+            TEST_ASSERT(&*nested != pooled_context);
+            TEST_ASSERT(nested->bytes().empty());
+        }
+        const sbs::PooledSerializeContext context = sbs::acquire_serialize_context();
+        TEST_ASSERT(&*context == pooled_context);
+        TEST_ASSERT(context->bytes().empty());
+        TEST_ASSERT(context->capacity() > 0);
+    }
+}
+
+inline void deserialize_with_limits()
+{
+    test_case("deserialize with limits");
+
+    const auto throws = [](const std::span<const std::byte> bytes, auto value, const sbs::ArchiveOptions& options) {
+        try {
+            sbs::deserialize_from_span(bytes, value, options);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+
+    std::vector<uint32_t> numbers(100);
+    std::vector<std::string> strings { "one", std::string(100, 'x'), "three" };
+
+    test_section("max length");
+    {
+        sbs::ArchiveOptions options;
+        options.max_length = 100;
+        TEST_ASSERT(!throws(sbs::serialize_to_vector(numbers), std::vector<uint32_t> { }, options));
+        TEST_ASSERT(!throws(sbs::serialize_to_vector(strings), std::vector<std::string> { }, options));
+        options.max_length = 99;
+        TEST_ASSERT(throws(sbs::serialize_to_vector(numbers), std::vector<uint32_t> { }, options));
+        TEST_ASSERT(throws(sbs::serialize_to_vector(strings), std::vector<std::string> { }, options));
+    }
+
+    test_section("memory budget");
+    {
+        sbs::ArchiveOptions options;
+        options.memory_budget = 100 * sizeof(uint32_t);
+        TEST_ASSERT(!throws(sbs::serialize_to_vector(numbers), std::vector<uint32_t> { }, options));
+        options.memory_budget -= 1;
+        TEST_ASSERT(throws(sbs::serialize_to_vector(numbers), std::vector<uint32_t> { }, options));
+        // The characters of each string count towards the same budget as the vector.
+        options.memory_budget = 3 * sizeof(std::string) + 108;
+        TEST_ASSERT(!throws(sbs::serialize_to_vector(strings), std::vector<std::string> { }, options));
+        options.memory_budget -= 1;
+        TEST_ASSERT(throws(sbs::serialize_to_vector(strings), std::vector<std::string> { }, options));
+    }
+
+    test_section("corrupt sizes");
+    {
+        // A size far larger than the input, which must fail without first allocating for it.
+        std::vector<std::byte> bytes(sizeof(uint64_t) + 16);
+        const uint64_t size = uint64_t(1) << 40;
+        std::memcpy(bytes.data(), &size, sizeof(size));
+        if constexpr (std::endian::native == std::endian::big) {
+            std::ranges::reverse(std::span(bytes).first(sizeof(size)));
+        }
+        TEST_ASSERT(throws(bytes, std::vector<uint64_t> { }, { }));
+        TEST_ASSERT(throws(bytes, std::vector<std::string> { }, { }));
+        TEST_ASSERT(throws(bytes, std::string { }, { }));
+
+        const auto throws_chunked = [&bytes](auto value) {
+            ChunkedReader reader { bytes };
+            try {
+                sbs::deserialize_using_reader(value, reader);
+            } catch (const std::runtime_error&) {
+                return true;
+            }
+            return false;
+        };
+        TEST_ASSERT(throws_chunked(std::vector<uint64_t> { }));
+        TEST_ASSERT(throws_chunked(std::vector<std::string> { }));
+        TEST_ASSERT(throws_chunked(std::string { }));
+    }
+
+    test_section("chunked growth");
+    {
+        std::vector<uint64_t> large_in(100000);
+        for (size_t i = 0; i < large_in.size(); ++i) {
+            large_in[i] = i;
+        }
+        const std::vector<std::byte> bytes = sbs::serialize_to_vector(large_in, std::endian::big);
+        ChunkedReader reader { bytes };
+        std::vector<uint64_t> large_out { 1, 2, 3 };
+        sbs::deserialize_using_reader(large_out, reader, std::endian::big);
+        TEST_ASSERT(large_in == large_out);
+
+        std::vector<std::string> strings_in(20000, std::string(10, 's'));
+        const std::vector<std::byte> string_bytes = sbs::serialize_to_vector(strings_in);
+        ChunkedReader string_reader { string_bytes };
+        std::vector<std::string> strings_out;
+        sbs::deserialize_using_reader(strings_out, string_reader);
+        TEST_ASSERT(strings_in == strings_out);
+    }
+}
+
+inline void serialize_into_span()
+{
+    test_case("serialize into span");
+
+    std::vector<std::string> value { "one", "two", "three" };
+    const std::vector<std::byte> expected = sbs::serialize_to_vector(value, std::endian::big);
+
+    test_section("serialize_into");
+    {
+        std::vector<std::byte> buffer(expected.size() + 8, std::byte { 0xaa });
+        const std::optional<size_t> size = sbs::serialize_into(buffer, value, std::endian::big);
+        TEST_ASSERT(size == expected.size());
+        TEST_ASSERT(std::ranges::equal(std::span(buffer).first(expected.size()), expected));
+        TEST_ASSERT(buffer.back() == std::byte { 0xaa });
+
+        std::ranges::fill(buffer, std::byte { 0xaa });
+        const std::span<std::byte> short_buffer = std::span(buffer).first(expected.size() - 1);
+        TEST_ASSERT(!sbs::serialize_into(short_buffer, value, std::endian::big).has_value());
+        TEST_ASSERT(buffer[expected.size() - 1] == std::byte { 0xaa });
+
+        sbs::SpanWriter writer { short_buffer };
+        sbs::serialize_using_writer(value, writer);
+        TEST_ASSERT(writer.overflowed());
+        TEST_ASSERT(writer.size() == expected.size());
+
+        std::vector<uint64_t> numbers(100, 7);
+        std::array<std::byte, 128> small_buffer;
+        TEST_ASSERT(!sbs::serialize_into(small_buffer, numbers, std::endian::big).has_value());
+        TEST_ASSERT(!sbs::serialize_into(std::span<std::byte> { }, numbers).has_value());
+    }
+
+    test_section("serialize_to_array");
+    {
+        const std::optional<sbs::FixedBuffer<64>> buffer = sbs::serialize_to_array<64>(value, std::endian::big);
+        TEST_ASSERT(buffer.has_value());
+        TEST_ASSERT(std::ranges::equal(buffer->bytes(), expected));
+        std::vector<std::string> value_out;
+        sbs::deserialize_from_span(buffer->bytes(), value_out, std::endian::big);
+        TEST_ASSERT(value == value_out);
+
+        std::string long_string(100, 'x');
+        TEST_ASSERT(!sbs::serialize_to_array<64>(long_string).has_value());
+        TEST_ASSERT((sbs::serialize_to_array<64, sbs::StringSerializer>(value[0]).has_value()));
+    }
+}
+
+inline void serialize_using_async_file()
+{
+    test_case("serialize using async file");
+
+    const std::filesystem::path path = "tests/temp/async_file.bin";
+    std::vector<std::string> value;
+    for (int i = 0; i < 2000; ++i) {
+        value.push_back(std::string(static_cast<size_t>(i % 50), static_cast<char>('a' + i % 26)));
+    }
+    const std::vector<std::byte> expected = sbs::serialize_to_vector(value, std::endian::big);
+
+    test_section("buffer sizes");
+    {
+        for (const size_t buffer_size : { 1, 7, 1000, 1 << 20 }) {
+            sbs::AsyncFileWriterOptions options { .buffer_size = buffer_size, .buffer_count = 3 };
+            sbs::serialize_to_file_async(path, value, std::endian::big, options);
+            const sbs::MappedFile file { path };
+            TEST_ASSERT(std::ranges::equal(file.bytes(), expected));
+        }
+    }
+
+    test_section("sync on finish");
+    {
+        sbs::AsyncFileWriter writer { path, { .buffer_size = 4096, .buffer_count = 2, .sync_on_finish = true } };
+        sbs::serialize_using_writer(value, writer, std::endian::big);
+        writer.finish();
+        const sbs::MappedFile file { path };
+        TEST_ASSERT(std::ranges::equal(file.bytes(), expected));
+    }
+
+#if defined(__linux__)
+    test_section("write error");
+    {
+        // Every write to /dev/full fails, which is only observed once the background thread has tried.
+        bool thrown = false;
+        try {
+            sbs::serialize_to_file_async("/dev/full", value, { }, { .buffer_size = 1000 });
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+    }
+#endif
+
     std::filesystem::remove(path);
-}
\ No newline at end of file
+}
+
+inline void serialize_scatter_gather()
+{
+    test_case("serialize scatter gather");
+
+    struct Message {
+        uint32_t id;
+        std::string name;
+        std::vector<std::byte> payload;
+        std::vector<std::string> attachments;
+
+        void serialize(sbs::Archive& ar)
+        {
+            ar.archive(id);
+            ar.archive(name);
+            ar.archive<sbs::ReferenceSerializer<std::vector<std::byte>>>(payload);
+            ar.archive(attachments);
+        }
+
+        bool operator==(const Message& other) const = default;
+    };
+
+    Message message_in { .id = 7, .name = "snapshot", .payload = { }, .attachments = { } };
+    message_in.payload.resize(100'000);
+    for (size_t i = 0; i < message_in.payload.size(); ++i) {
+        message_in.payload[i] = static_cast<std::byte>(i * 13);
+    }
+    for (size_t i = 0; i < 1500; ++i) {
+        message_in.attachments.push_back(std::string(i % 3 == 0 ? 5000 : 10, static_cast<char>('a' + i % 26)));
+    }
+
+    auto concatenate = [](const sbs::ScatterGatherWriter& writer) {
+        std::vector<std::byte> bytes;
+        for (const std::span<const std::byte> segment : writer.segments()) {
+            bytes.insert(bytes.end(), segment.begin(), segment.end());
+        }
+        return bytes;
+    };
+
+    test_section("payloads are referenced");
+    {
+        sbs::ScatterGatherWriter writer;
+        sbs::serialize_using_writer<sbs::DefaultSerializer<Message>>(message_in, writer);
+        TEST_ASSERT(writer.size() == sbs::serialized_size(message_in));
+        TEST_ASSERT(concatenate(writer) == sbs::serialize_to_vector(message_in));
+        const std::vector<std::span<const std::byte>> segments = writer.segments();
+        TEST_ASSERT(std::ranges::any_of(segments, [&](const std::span<const std::byte> segment) {
+            return segment.data() == message_in.payload.data() && segment.size() == message_in.payload.size();
+        }));
+        TEST_ASSERT(std::ranges::none_of(segments, [&](const std::span<const std::byte> segment) {
+            return segment.data() == reinterpret_cast<const std::byte*>(message_in.name.data());
+        }));
+        // Containers archived by their default serializers are copied.
+        TEST_ASSERT(std::ranges::none_of(segments, [&](const std::span<const std::byte> segment) {
+            return segment.data() == reinterpret_cast<const std::byte*>(message_in.attachments[0].data());
+        }));
+    }
+
+    test_section("temporaries are copied");
+    {
+        // The map serializer archives a copy of each key which is destroyed before the output is written.
+        std::map<std::string, int> map_in;
+        for (int i = 0; i < 4; ++i) {
+            map_in.emplace(std::string(8000, static_cast<char>('a' + i)), i);
+        }
+        sbs::ScatterGatherWriter writer;
+        sbs::serialize_using_writer<sbs::DefaultSerializer<std::map<std::string, int>>>(map_in, writer);
+        TEST_ASSERT(writer.segments().size() == 1);
+        const std::vector<std::byte> bytes = concatenate(writer);
+        TEST_ASSERT(bytes == sbs::serialize_to_vector(map_in));
+        std::map<std::string, int> map_out;
+        sbs::deserialize_from_span(bytes, map_out);
+        TEST_ASSERT(map_in == map_out);
+    }
+
+    test_section("ReferenceSerializer");
+    {
+        std::string string(10'000, 'x');
+        std::array<uint8_t, 5000> array { };
+        array[1] = 1;
+        for (const std::endian endian : { std::endian::little, std::endian::big }) {
+            sbs::ScatterGatherWriter writer;
+            sbs::serialize_using_writer<sbs::ReferenceSerializer<std::string>>(string, writer, endian);
+            sbs::serialize_using_writer<sbs::ReferenceSerializer<std::array<uint8_t, 5000>>>(array, writer, endian);
+            TEST_ASSERT(writer.segments().size() == 3);
+            std::vector<std::byte> expected = sbs::serialize_to_vector(string, endian);
+            const std::vector<std::byte> array_bytes = sbs::serialize_to_vector(array, endian);
+            expected.insert(expected.end(), array_bytes.begin(), array_bytes.end());
+            TEST_ASSERT(concatenate(writer) == expected);
+
+            std::string string_out;
+            sbs::deserialize_from_span<sbs::ReferenceSerializer<std::string>>(expected, string_out, endian);
+            TEST_ASSERT(string == string_out);
+        }
+    }
+
+    test_section("min_reference_size");
+    {
+        for (const size_t min_reference_size : { 0, 1, 9, 4096, 1'000'000 }) {
+            sbs::ScatterGatherWriter writer { { .min_reference_size = min_reference_size } };
+            sbs::serialize_using_writer<sbs::DefaultSerializer<Message>>(message_in, writer, std::endian::big);
+            TEST_ASSERT(concatenate(writer) == sbs::serialize_to_vector(message_in, std::endian::big));
+        }
+    }
+
+    test_section("clear");
+    {
+        sbs::ScatterGatherWriter writer;
+        sbs::serialize_using_writer<sbs::DefaultSerializer<Message>>(message_in, writer);
+        writer.clear();
+        TEST_ASSERT(writer.size() == 0 && writer.segments().empty());
+        std::string string = "reused";
+        sbs::serialize_using_writer<sbs::DefaultSerializer<std::string>>(string, writer);
+        TEST_ASSERT(concatenate(writer) == sbs::serialize_to_vector(string));
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    test_section("serialize_to_fd");
+    {
+        const std::filesystem::path path = "tests/temp/scatter_gather.bin";
+        const int file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        TEST_ASSERT(file != -1);
+        sbs::serialize_to_fd(file, message_in);
+        ::close(file);
+        Message message_out { };
+        sbs::deserialize_from_file(path, message_out);
+        TEST_ASSERT(message_in == message_out);
+        std::filesystem::remove(path);
+    }
+#endif
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+inline void serialize_using_shared_ring()
+{
+    test_case("serialize using shared ring");
+
+    struct Message {
+        uint32_t id;
+        std::string text;
+
+        void serialize(sbs::Archive& ar)
+        {
+            ar.archive(id);
+            ar.archive(text);
+        }
+
+        bool operator==(const Message& other) const = default;
+    };
+
+    const std::string name = "/sbs_tests_ring_" + std::to_string(::getpid());
+    sbs::SharedRing::remove(name);
+    auto make_message = [](const uint32_t id) {
+        return Message { .id = id, .text = std::string(id * 37 % 9000, static_cast<char>('a' + id % 26)) };
+    };
+
+    test_section("messages across wrap-around until closed");
+    {
+        sbs::SharedRing writer_ring = sbs::SharedRing::create(name, { .capacity = 1 });
+        sbs::SharedRing reader_ring = sbs::SharedRing::open(name);
+        sbs::SharedRing::remove(name);
+        TEST_ASSERT(writer_ring.capacity() == reader_ring.capacity());
+        TEST_ASSERT(writer_ring.capacity() >= 1);
+        constexpr uint32_t count = 300;
+        std::thread writer_thread { [&] {
+            sbs::SharedRingWriter writer { writer_ring };
+            for (uint32_t id = 0; id < count; ++id) {
+                Message message = make_message(id);
+                sbs::serialize_using_writer<sbs::DefaultSerializer<Message>>(message, writer);
+            }
+            writer.close();
+        } };
+        sbs::SharedRingReader reader { reader_ring };
+        bool equal = true;
+        for (uint32_t id = 0; id < count; ++id) {
+            Message message { };
+            sbs::deserialize_using_reader<sbs::DefaultSerializer<Message>>(message, reader);
+            equal = equal && message == make_message(id);
+        }
+        TEST_ASSERT(equal);
+        bool thrown = false;
+        try {
+            Message message { };
+            sbs::deserialize_using_reader<sbs::DefaultSerializer<Message>>(message, reader);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+        writer_thread.join();
+    }
+
+    test_section("invalid names");
+    {
+        bool thrown = false;
+        try {
+            static_cast<void>(sbs::SharedRing::open(name));
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+        sbs::SharedRing ring = sbs::SharedRing::create(name);
+        thrown = false;
+        try {
+            static_cast<void>(sbs::SharedRing::create(name));
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+        sbs::SharedRing::remove(name);
+    }
+}
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+inline void serialize_using_fd()
+{
+    test_case("serialize using fd");
+
+    struct Message {
+        std::string name;
+        std::vector<uint32_t> values;
+
+        void serialize(sbs::Archive& ar)
+        {
+            ar.archive(name);
+            ar.archive(values);
+        }
+
+        bool operator==(const Message& other) const = default;
+    };
+
+    Message message_in { .name = "values", .values = { } };
+    for (uint32_t i = 0; i < 100'000; ++i) {
+        message_in.values.push_back(i * 2654435761u);
+    }
+    auto make_pipe = [](const bool non_blocking) {
+        std::array<int, 2> pipe { };
+        TEST_ASSERT(::pipe(pipe.data()) == 0);
+        if (non_blocking) {
+            for (const int file : pipe) {
+                ::fcntl(file, F_SETFL, ::fcntl(file, F_GETFL) | O_NONBLOCK);
+            }
+        }
+        return pipe;
+    };
+
+    for (const bool non_blocking : { false, true }) {
+        test_section(non_blocking ? "non-blocking pipe with backpressure" : "blocking pipe");
+        const std::array<int, 2> pipe = make_pipe(non_blocking);
+        size_t max_pending_size = 0;
+        std::thread writer_thread { [&] {
+            sbs::FdWriter writer { pipe[1], { .buffer_size = 1000, .max_pending_size = 16 * 1024, .timeout_ms = -1 } };
+            for (int i = 0; i < 3; ++i) {
+                sbs::serialize_using_writer<sbs::DefaultSerializer<Message>>(message_in, writer);
+                max_pending_size = std::max(max_pending_size, writer.pending_size());
+            }
+            writer.flush();
+            ::close(pipe[1]);
+        } };
+        sbs::FdReader reader { pipe[0], { .buffer_size = 100 } };
+        bool equal = true;
+        for (int i = 0; i < 3; ++i) {
+            Message message_out { };
+            sbs::deserialize_using_reader<sbs::DefaultSerializer<Message>>(message_out, reader);
+            equal = equal && message_in == message_out;
+        }
+        TEST_ASSERT(equal);
+        TEST_ASSERT(reader.data(1).empty() && reader.eof());
+        writer_thread.join();
+        TEST_ASSERT(max_pending_size <= 16 * 1024);
+        ::close(pipe[0]);
+    }
+
+    test_section("would block");
+    {
+        const std::array<int, 2> pipe = make_pipe(true);
+        sbs::FdWriter writer { pipe[1] };
+        sbs::serialize_using_writer<sbs::DefaultSerializer<Message>>(message_in, writer);
+        TEST_ASSERT(writer.pending_size() > 0);
+        TEST_ASSERT(writer.try_flush() == sbs::IoStatus::would_block);
+        sbs::FdReader reader { pipe[0] };
+        sbs::IncrementalDeserializer<Message> deserializer;
+        while (deserializer.feed(reader.read_available()) == sbs::IncrementalStatus::need_more_data) {
+            writer.try_flush();
+        }
+        TEST_ASSERT(writer.try_flush() == sbs::IoStatus::complete);
+        TEST_ASSERT(deserializer.value() == message_in);
+        TEST_ASSERT(reader.read_available().empty());
+        ::close(pipe[0]);
+        ::close(pipe[1]);
+    }
+
+    test_section("timeout");
+    {
+        const std::array<int, 2> pipe = make_pipe(true);
+        bool thrown = false;
+        try {
+            sbs::FdWriter writer { pipe[1], { .buffer_size = 1000, .max_pending_size = 0, .timeout_ms = 10 } };
+            sbs::serialize_using_writer<sbs::DefaultSerializer<Message>>(message_in, writer);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+        ::close(pipe[0]);
+        ::close(pipe[1]);
+    }
+
+    test_section("closed socket");
+    {
+        std::array<int, 2> sockets { };
+        TEST_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets.data()) == 0);
+        ::close(sockets[1]);
+        bool thrown = false;
+        try {
+            sbs::FdWriter writer { sockets[0] };
+            sbs::serialize_using_writer<sbs::DefaultSerializer<Message>>(message_in, writer);
+            writer.flush();
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+        ::close(sockets[0]);
+    }
+}
+#endif
+
+inline void serialize_with_reserved_size()
+{
+    test_case("serialize with reserved size");
+
+    // Archives only the even numbers, counting them while archiving them.
+    struct EvenNumbers {
+        std::string label;
+        std::vector<uint32_t> numbers;
+
+        void serialize(sbs::Archive& ar)
+        {
+            ar.archive(label);
+            if (ar.deserializing()) {
+                ar.archive(numbers);
+                return;
+            }
+            const sbs::SizeSlot slot = ar.reserve_size();
+            uint64_t size = 0;
+            for (uint32_t number : numbers) {
+                if (number % 2 == 0) {
+                    ar.archive(number);
+                    ++size;
+                }
+            }
+            ar.patch_size(slot, size);
+        }
+    };
+
+    EvenNumbers value { .label = "even numbers", .numbers = { } };
+    std::vector<uint32_t> evens;
+    for (uint32_t i = 0; i < 20'000; ++i) {
+        value.numbers.push_back(i * 7);
+        if (i * 7 % 2 == 0) {
+            evens.push_back(i * 7);
+        }
+    }
+    auto expected_bytes = [&](const sbs::ArchiveOptions& options) {
+        EvenNumbers expected { .label = value.label, .numbers = evens };
+        std::vector<std::byte> bytes;
+        sbs::VectorWriter writer { bytes };
+        auto ar = sbs::Archive::create_for_serializing(writer, options);
+        ar.archive(expected.label);
+        ar.archive(expected.numbers);
+        ar.sync();
+        return bytes;
+    };
+    const std::vector<std::byte> expected = expected_bytes(std::endian::little);
+
+    test_section("vector, span and context");
+    {
+        TEST_ASSERT(sbs::serialize_to_vector(value) == expected);
+        TEST_ASSERT(sbs::serialize_to_vector(value, std::endian::big) == expected_bytes(std::endian::big));
+        TEST_ASSERT(sbs::serialized_size(value) == expected.size());
+        std::vector<std::byte> buffer(expected.size());
+        TEST_ASSERT(sbs::serialize_into(buffer, value) == expected.size());
+        TEST_ASSERT(buffer == expected);
+        std::array<std::byte, 16> small_buffer { };
+        TEST_ASSERT(!sbs::serialize_into(small_buffer, value).has_value());
+        sbs::SerializeContext context;
+        static_cast<void>(context.serialize(value));
+        const std::span<const std::byte> bytes = context.serialize(value);
+        TEST_ASSERT(std::ranges::equal(bytes, expected));
+    }
+
+    test_section("file");
+    {
+        const std::filesystem::path path = "tests/temp/reserved_size.bin";
+        for (const sbs::FileWriterOptions& options :
+             { sbs::FileWriterOptions { .buffer_size = 16 },
+               sbs::FileWriterOptions { .buffer_size = 4096, .direct_io = true } }) {
+            sbs::serialize_to_file(path, value, { }, options);
+            const sbs::MappedFile file { path };
+            TEST_ASSERT(std::ranges::equal(file.bytes(), expected));
+        }
+        std::filesystem::remove(path);
+    }
+
+    test_section("varint size encoding");
+    {
+        sbs::ArchiveOptions options;
+        options.size_encoding = sbs::SizeEncoding::varint;
+        const std::vector<std::byte> bytes = sbs::serialize_to_vector(value, options);
+        TEST_ASSERT(bytes.size() == sbs::serialized_size(value, options));
+        EvenNumbers value_out { };
+        sbs::deserialize_from_span(bytes, value_out, options);
+        TEST_ASSERT(value_out.label == value.label && value_out.numbers == evens);
+    }
+
+    test_section("unpatchable writer");
+    {
+        bool thrown = false;
+        try {
+            sbs::ScatterGatherWriter writer;
+            sbs::serialize_using_writer<sbs::DefaultSerializer<EvenNumbers>>(value, writer);
+        } catch (const std::logic_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+    }
+}
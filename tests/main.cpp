@@ -19,6 +19,23 @@ int main()
         serialize_function_serializable();
         serialize_nested_structs();
         serialize_using_file();
+        serialize_using_async_file();
+        serialize_using_writer_and_reader();
+        serialize_counting();
+        serialize_varint();
+        serialize_compressed();
+        serialize_checksummed();
+        serialize_chunks();
+        deserialize_incrementally();
+        serialize_with_context();
+        deserialize_with_limits();
+        serialize_into_span();
+        serialize_scatter_gather();
+        serialize_with_reserved_size();
+#if defined(__unix__) || defined(__APPLE__)
+        serialize_using_shared_ring();
+        serialize_using_fd();
+#endif
 
         serialize_array();
         serialize_bitset();
@@ -27,16 +44,22 @@ int main()
         serialize_deque();
         serialize_filesystem();
         serialize_forward_list();
+        serialize_indexed();
         serialize_list();
         serialize_map();
         serialize_memory();
         serialize_optional();
+        serialize_parallel();
+        serialize_pmr();
         serialize_set();
+        serialize_span();
         serialize_string();
+        serialize_string_view();
         serialize_unordered_map();
         serialize_unordered_set();
         serialize_utility();
         serialize_variant();
+        serialize_vector();
 
         END_TESTS;
     } catch (const std::exception& exception) {
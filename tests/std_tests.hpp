@@ -8,12 +8,16 @@
 #include <sbs/serializers/deque.hpp>
 #include <sbs/serializers/filesystem.hpp>
 #include <sbs/serializers/forward_list.hpp>
+#include <sbs/serializers/indexed.hpp>
 #include <sbs/serializers/list.hpp>
 #include <sbs/serializers/map.hpp>
 #include <sbs/serializers/memory.hpp>
 #include <sbs/serializers/optional.hpp>
+#include <sbs/serializers/parallel.hpp>
 #include <sbs/serializers/set.hpp>
+#include <sbs/serializers/span.hpp>
 #include <sbs/serializers/string.hpp>
+#include <sbs/serializers/string_view.hpp>
 #include <sbs/serializers/unordered_map.hpp>
 #include <sbs/serializers/unordered_set.hpp>
 #include <sbs/serializers/utility.hpp>
@@ -239,6 +243,137 @@ inline void serialize_forward_list()
     }
 }
 
+inline void serialize_indexed()
+{
+    test_case("serialize indexed");
+
+    constexpr sbs::IndexOptions options { .stride = 64, .threshold = 1000, .threads = 4 };
+    using Serializer = sbs::IndexedVectorSerializer<std::string, sbs::DefaultSerializer<std::string>, options>;
+
+    std::vector<std::string> vector_in;
+    for (int i = 0; i < 5003; ++i) {
+        vector_in.push_back(std::string(static_cast<size_t>(i % 11), static_cast<char>('a' + i % 26)));
+    }
+
+    test_section("round trip");
+    {
+        sbs::ArchiveOptions archive_options { std::endian::big };
+        archive_options.size_encoding = sbs::SizeEncoding::varint;
+        const std::vector<std::byte> bytes = sbs::serialize_to_vector<Serializer>(vector_in, archive_options);
+        TEST_ASSERT(sbs::serialized_size<Serializer>(vector_in, archive_options) == bytes.size());
+        std::vector<std::string> vector_out { "stale" };
+        sbs::deserialize_from_span<Serializer>(bytes, vector_out, archive_options);
+        TEST_ASSERT(vector_in == vector_out);
+
+        using SerialSerializer
+            = sbs::IndexedVectorSerializer<std::string, sbs::DefaultSerializer<std::string>, sbs::IndexOptions { 64 }>;
+        TEST_ASSERT(sbs::serialize_to_vector<SerialSerializer>(vector_in, archive_options) == bytes);
+
+        // A single group too large to allocate at once grows as its elements are read.
+        using LargeGroupSerializer = sbs::
+            IndexedVectorSerializer<std::string, sbs::DefaultSerializer<std::string>, sbs::IndexOptions { 1 << 20 }>;
+        const std::vector<std::byte> large_group_bytes
+            = sbs::serialize_to_vector<LargeGroupSerializer>(vector_in, archive_options);
+        vector_out.clear();
+        sbs::deserialize_from_span<LargeGroupSerializer>(large_group_bytes, vector_out, archive_options);
+        TEST_ASSERT(vector_in == vector_out);
+
+        ChunkedReader reader { bytes };
+        vector_out.clear();
+        sbs::deserialize_using_reader<Serializer>(vector_out, reader, archive_options);
+        TEST_ASSERT(vector_in == vector_out);
+        TEST_ASSERT(reader.remaining() == 0);
+
+        std::vector<std::string> empty_in;
+        const std::vector<std::byte> empty_bytes = sbs::serialize_to_vector<Serializer>(empty_in);
+        sbs::deserialize_from_span<Serializer>(empty_bytes, vector_out);
+        TEST_ASSERT(vector_out.empty());
+    }
+
+    test_section("random access");
+    {
+        const std::vector<std::byte> bytes = sbs::serialize_to_vector<Serializer>(vector_in);
+        const sbs::IndexedVectorView<std::string> view { bytes };
+        TEST_ASSERT(view.size() == vector_in.size());
+        for (const size_t index : { size_t { 0 }, size_t { 63 }, size_t { 64 }, size_t { 2500 }, size_t { 5002 } }) {
+            TEST_ASSERT(view.at(index) == vector_in[index]);
+        }
+        bool out_of_range = false;
+        try {
+            (void)view.at(vector_in.size());
+        } catch (const std::out_of_range&) {
+            out_of_range = true;
+        }
+        TEST_ASSERT(out_of_range);
+    }
+
+    test_section("invalid index");
+    {
+        const auto throws = [](const std::vector<std::byte>& bytes) {
+            try {
+                std::vector<std::string> vector_out;
+                sbs::deserialize_from_span<Serializer>(bytes, vector_out);
+            } catch (const std::runtime_error&) {
+                return true;
+            }
+            return false;
+        };
+        std::vector<std::string> small_in { "one", "two", "three" };
+        std::vector<std::byte> bytes = sbs::serialize_to_vector<Serializer>(small_in);
+        TEST_ASSERT(!throws(bytes));
+        // The stride follows the 8 byte size.
+        std::vector<std::byte> zero_stride = bytes;
+        zero_stride[8] = std::byte { 0 };
+        TEST_ASSERT(throws(zero_stride));
+        // The group length follows the stride, and a shorter group leaves elements unread.
+        std::vector<std::byte> short_group = bytes;
+        short_group[16] = std::byte { 4 };
+        TEST_ASSERT(throws(short_group));
+        bytes.pop_back();
+        TEST_ASSERT(throws(bytes));
+
+        // A huge size and stride with a single short group must not be allocated before the elements are read.
+        std::vector<std::byte> huge_size(16, std::byte { 0 });
+        huge_size[5] = huge_size[13] = std::byte { 1 };
+        huge_size.push_back(std::byte { 3 });
+        huge_size.insert(huge_size.end(), 3, std::byte { 'a' });
+        TEST_ASSERT(throws(huge_size));
+
+        using NumberSerializer = sbs::IndexedVectorSerializer<uint32_t, sbs::DefaultSerializer<uint32_t>, options>;
+        std::vector<uint32_t> numbers_in(1000, 7);
+        std::vector<std::byte> number_bytes = sbs::serialize_to_vector<NumberSerializer>(numbers_in);
+        number_bytes[1] = std::byte { 0x10 };
+        bool thrown = false;
+        try {
+            std::vector<uint32_t> numbers_out;
+            sbs::deserialize_from_span<NumberSerializer>(number_bytes, numbers_out);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+    }
+
+    test_section("memory budget");
+    {
+        // The characters of every group count towards the budget of the whole vector, not each group separately.
+        std::vector<std::string> long_in(2000, std::string(1000, 'x'));
+        const auto throws = [&](const std::vector<std::byte>& bytes, const uint64_t memory_budget) {
+            sbs::ArchiveOptions archive_options;
+            archive_options.memory_budget = memory_budget;
+            try {
+                std::vector<std::string> vector_out;
+                sbs::deserialize_from_span<Serializer>(bytes, vector_out, archive_options);
+            } catch (const std::runtime_error&) {
+                return true;
+            }
+            return false;
+        };
+        const std::vector<std::byte> bytes = sbs::serialize_to_vector<Serializer>(long_in);
+        TEST_ASSERT(!throws(bytes, 4 << 20));
+        TEST_ASSERT(throws(bytes, 1 << 20));
+    }
+}
+
 inline void serialize_list()
 {
     test_case("serialize <list>");
@@ -413,6 +548,203 @@ inline void serialize_optional()
     }
 }
 
+inline void serialize_parallel()
+{
+    test_case("serialize parallel");
+
+    struct Record {
+        uint32_t id;
+        std::string name;
+
+        void serialize(sbs::Archive& ar)
+        {
+            ar.archive(id);
+            ar.archive(name);
+        }
+
+        bool operator==(const Record& other) const
+        {
+            return id == other.id && name == other.name;
+        }
+    };
+
+    constexpr sbs::ParallelOptions options { .threshold = 100, .threads = 4, .min_chunk_size = 16 };
+    sbs::ArchiveOptions archive_options { std::endian::big };
+    archive_options.size_encoding = sbs::SizeEncoding::varint;
+
+    test_section("vector");
+    {
+        std::vector<Record> vector_in;
+        for (uint32_t i = 0; i < 10007; ++i) {
+            vector_in.push_back({ .id = i, .name = std::string(i % 13, 'a') });
+        }
+        using Serializer = sbs::ParallelVectorSerializer<Record, sbs::DefaultSerializer<Record>, options>;
+        const std::vector<std::byte> bytes = sbs::serialize_to_vector<Serializer>(vector_in, archive_options);
+        TEST_ASSERT(bytes == sbs::serialize_to_vector(vector_in, archive_options));
+        TEST_ASSERT(sbs::serialized_size<Serializer>(vector_in, archive_options) == bytes.size());
+        std::vector<Record> vector_out;
+        sbs::deserialize_from_span<Serializer>(bytes, vector_out, archive_options);
+        TEST_ASSERT(vector_in == vector_out);
+
+        std::vector<Record> small_in(vector_in.begin(), vector_in.begin() + 50);
+        TEST_ASSERT(sbs::serialize_to_vector<Serializer>(small_in) == sbs::serialize_to_vector(small_in));
+    }
+
+    test_section("deque");
+    {
+        std::deque<std::string> deque_in;
+        for (int i = 0; i < 1000; ++i) {
+            deque_in.push_back(std::to_string(i));
+        }
+        using Serializer = sbs::ParallelDequeSerializer<std::string, sbs::DefaultSerializer<std::string>, options>;
+        const std::vector<std::byte> bytes = sbs::serialize_to_vector<Serializer>(deque_in);
+        TEST_ASSERT(bytes == sbs::serialize_to_vector(deque_in));
+        std::deque<std::string> deque_out;
+        sbs::deserialize_from_span<Serializer>(bytes, deque_out);
+        TEST_ASSERT(deque_in == deque_out);
+    }
+
+    test_section("array");
+    {
+        std::array<std::string, 300> array_in;
+        for (size_t i = 0; i < array_in.size(); ++i) {
+            array_in[i] = std::string(i % 5, 'b');
+        }
+        using Serializer
+            = sbs::ParallelArraySerializer<std::string, 300, sbs::DefaultSerializer<std::string>, options>;
+        const std::vector<std::byte> bytes = sbs::serialize_to_vector<Serializer>(array_in);
+        TEST_ASSERT(bytes == sbs::serialize_to_vector(array_in));
+        std::array<std::string, 300> array_out;
+        sbs::deserialize_from_span<Serializer>(bytes, array_out);
+        TEST_ASSERT(array_in == array_out);
+    }
+
+    test_section("nested");
+    {
+        // The inner vectors are serialized serially by the workers of the shared pool.
+        std::vector<std::vector<Record>> nested_in(200);
+        for (size_t i = 0; i < nested_in.size(); ++i) {
+            for (uint32_t j = 0; j < 150; ++j) {
+                nested_in[i].push_back({ .id = j, .name = std::string(i % 7, 'c') });
+            }
+        }
+        using Inner = sbs::ParallelVectorSerializer<Record, sbs::DefaultSerializer<Record>, options>;
+        using Serializer = sbs::ParallelVectorSerializer<std::vector<Record>, Inner, options>;
+        for (int i = 0; i < 3; ++i) {
+            TEST_ASSERT(sbs::serialize_to_vector<Serializer>(nested_in) == sbs::serialize_to_vector(nested_in));
+        }
+    }
+
+    test_section("exception");
+    {
+        struct Throwing {
+            uint32_t id;
+
+            void serialize(sbs::Archive& ar)
+            {
+                if (id == 500) {
+                    throw std::runtime_error("Throwing");
+                }
+                ar.archive(id);
+            }
+        };
+        std::vector<Throwing> vector_in(1000);
+        for (uint32_t i = 0; i < vector_in.size(); ++i) {
+            vector_in[i].id = i;
+        }
+        using Serializer = sbs::ParallelVectorSerializer<Throwing, sbs::DefaultSerializer<Throwing>, options>;
+        bool thrown = false;
+        try {
+            static_cast<void>(sbs::serialize_to_vector<Serializer>(vector_in));
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+    }
+}
+
+inline void serialize_pmr()
+{
+    test_case("serialize <memory_resource>");
+
+    struct Message {
+        explicit Message(std::pmr::memory_resource* resource)
+            : name { resource }
+            , tags { resource }
+            , counts { resource }
+            , ids { resource }
+        {
+        }
+
+        std::pmr::string name;
+        std::pmr::vector<std::pmr::string> tags;
+        std::pmr::map<std::pmr::string, std::pmr::vector<int>> counts;
+        std::pmr::unordered_set<std::pmr::string> ids;
+        std::optional<std::pmr::string> note;
+        std::variant<int, std::pmr::string> choice;
+        std::unique_ptr<std::pmr::string, sbs::ResourceDeleter<std::pmr::string>> child;
+
+        void serialize(sbs::Archive& ar)
+        {
+            ar.archive(name);
+            ar.archive(tags);
+            ar.archive(counts);
+            ar.archive(ids);
+            ar.archive(note);
+            ar.archive(choice);
+            ar.archive(child);
+        }
+    };
+
+    // Strings longer than the small string buffer so that every one of them allocates.
+    const auto long_string = [](const char c) { return std::pmr::string(40, c); };
+
+    Message message_in { std::pmr::get_default_resource() };
+    message_in.name = long_string('n');
+    message_in.tags = { long_string('a'), long_string('b') };
+    message_in.counts[long_string('c')] = { 1, 2, 3 };
+    message_in.counts[long_string('d')] = { 4 };
+    message_in.ids = { long_string('e'), long_string('f') };
+    message_in.note = long_string('g');
+    message_in.choice = long_string('h');
+    message_in.child = { std::pmr::polymorphic_allocator<>().new_object<std::pmr::string>(long_string('i')), { } };
+    const std::vector<std::byte> bytes = sbs::serialize_to_vector(message_in);
+
+    test_section("arena");
+    {
+        std::array<std::byte, 8192> arena_buffer;
+        std::pmr::monotonic_buffer_resource arena {
+            arena_buffer.data(), arena_buffer.size(), std::pmr::null_memory_resource()
+        };
+        sbs::ArchiveOptions archive_options;
+        archive_options.memory_resource = &arena;
+        Message message_out { &arena };
+        // Any allocation outside of the arena throws.
+        std::pmr::memory_resource* default_resource = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        bool allocated_outside = false;
+        try {
+            sbs::deserialize_from_span(bytes, message_out, archive_options);
+        } catch (const std::bad_alloc&) {
+            allocated_outside = true;
+        }
+        std::pmr::set_default_resource(default_resource);
+        TEST_ASSERT(!allocated_outside);
+        TEST_ASSERT(message_out.name == message_in.name);
+        TEST_ASSERT(message_out.tags == message_in.tags);
+        TEST_ASSERT(message_out.counts == message_in.counts);
+        TEST_ASSERT(message_out.ids == message_in.ids);
+        TEST_ASSERT(message_out.note == message_in.note);
+        TEST_ASSERT(message_out.choice == message_in.choice);
+        TEST_ASSERT(*message_out.child == *message_in.child);
+        TEST_ASSERT(message_out.tags[0].get_allocator().resource() == &arena);
+        TEST_ASSERT(message_out.counts.begin()->first.get_allocator().resource() == &arena);
+        TEST_ASSERT(message_out.note->get_allocator().resource() == &arena);
+        TEST_ASSERT(std::get<1>(message_out.choice).get_allocator().resource() == &arena);
+        TEST_ASSERT(message_out.child.get_deleter().resource == &arena);
+        TEST_ASSERT(message_out.child->get_allocator().resource() == &arena);
+    }
+}
+
 inline void serialize_set()
 {
     test_case("serialize <set>");
@@ -478,6 +810,57 @@ inline void serialize_set()
     }
 }
 
+inline void serialize_span()
+{
+    test_case("serialize <span>");
+
+    test_section("std::span<const std::byte>");
+    {
+        const std::vector<std::byte> data { std::byte { 1 }, std::byte { 2 }, std::byte { 3 } };
+        std::span<const std::byte> span_in { data };
+        std::vector<std::byte> bytes = sbs::serialize_to_vector(span_in);
+        std::vector<std::byte> vector_in = data;
+        TEST_ASSERT(bytes == sbs::serialize_to_vector(vector_in));
+        std::span<const std::byte> span_out { };
+        sbs::deserialize_from_span(bytes, span_out);
+        TEST_ASSERT(std::ranges::equal(span_in, span_out));
+        TEST_ASSERT(span_out.data() == bytes.data() + sizeof(uint64_t));
+    }
+
+    test_section("std::span<const uint32_t>");
+    {
+        std::vector<uint32_t> vector_in { 1, 2, 3, 4 };
+        std::vector<std::byte> bytes = sbs::serialize_to_vector(vector_in, std::endian::native);
+        std::span<const uint32_t> span_out { };
+        sbs::deserialize_from_span(bytes, span_out, std::endian::native);
+        TEST_ASSERT(std::ranges::equal(vector_in, span_out));
+    }
+
+    test_section("std::span errors");
+    {
+        std::vector<uint32_t> vector_in { 1, 2, 3, 4 };
+        const std::endian non_native
+            = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+        std::vector<std::byte> bytes = sbs::serialize_to_vector(vector_in, non_native);
+        const auto throws = [](auto&& function) {
+            try {
+                function();
+            } catch (const std::runtime_error&) {
+                return true;
+            }
+            return false;
+        };
+        std::span<const uint32_t> span_out { };
+        TEST_ASSERT(throws([&] { sbs::deserialize_from_span(bytes, span_out, non_native); }));
+        bytes = sbs::serialize_to_vector(vector_in, std::endian::native);
+        bytes.insert(bytes.begin(), std::byte { 0 });
+        const std::span<const std::byte> misaligned = std::span(bytes).subspan(1);
+        TEST_ASSERT(throws([&] { sbs::deserialize_from_span(misaligned, span_out, std::endian::native); }));
+        ChunkedReader reader { misaligned };
+        TEST_ASSERT(throws([&] { sbs::deserialize_using_reader(span_out, reader, std::endian::native); }));
+    }
+}
+
 inline void serialize_string()
 {
     test_case("serialize <string>");
@@ -564,6 +947,49 @@ inline void serialize_string()
     }
 }
 
+inline void serialize_string_view()
+{
+    test_case("serialize <string_view>");
+
+    test_section("std::string_view");
+    {
+        {
+            std::string_view str_in = "Hello World!";
+            std::vector<std::byte> bytes = sbs::serialize_to_vector(str_in);
+            std::string string_in { str_in };
+            TEST_ASSERT(bytes == sbs::serialize_to_vector(string_in));
+            std::string_view str_out { };
+            sbs::deserialize_from_span(bytes, str_out);
+            TEST_ASSERT(str_in == str_out);
+            TEST_ASSERT(reinterpret_cast<const std::byte*>(str_out.data()) == bytes.data() + sizeof(uint64_t));
+            test_file("std_string", str_in, bytes);
+        }
+        {
+            std::string_view str_in { };
+            std::vector<std::byte> bytes = sbs::serialize_to_vector(str_in);
+            std::string_view str_out = "Hello World!";
+            sbs::deserialize_from_span(bytes, str_out);
+            TEST_ASSERT(str_in == str_out);
+            test_file("std_string_empty", str_in, bytes);
+        }
+    }
+
+    test_section("std::string_view streaming reader");
+    {
+        std::string_view str_in = "Hello World!";
+        std::vector<std::byte> bytes = sbs::serialize_to_vector(str_in);
+        ChunkedReader reader { bytes };
+        std::string_view str_out { };
+        bool thrown = false;
+        try {
+            sbs::deserialize_using_reader(str_out, reader);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        TEST_ASSERT(thrown);
+    }
+}
+
 inline void serialize_unordered_map()
 {
     test_case("serialize <unordered_map>");
@@ -824,4 +1250,45 @@ inline void serialize_vector()
             test_file("std_vector_empty", vector_in, bytes);
         }
     }
-}
\ No newline at end of file
+
+    test_section("std::vector bulk values");
+    {
+        const auto test_bulk = []<class Type>(std::vector<Type> vector_in) {
+            struct ElementSerializer {
+                void operator()(sbs::Archive& ar, Type& value) const
+                {
+                    ar.archive_value(value);
+                }
+            };
+
+            for (const std::endian endian : { std::endian::little, std::endian::big }) {
+                std::vector<std::byte> bytes = sbs::serialize_to_vector(vector_in, endian);
+                std::vector<std::byte> element_bytes
+                    = sbs::serialize_to_vector<sbs::VectorSerializer<Type, ElementSerializer>>(vector_in, endian);
+                TEST_ASSERT(bytes == element_bytes);
+                ChunkedWriter writer;
+                sbs::serialize_using_writer(vector_in, writer, endian);
+                TEST_ASSERT(bytes == writer.bytes);
+                std::vector<Type> vector_out { };
+                sbs::deserialize_from_span(bytes, vector_out, endian);
+                TEST_ASSERT(vector_in == vector_out);
+                ChunkedReader reader { bytes };
+                std::vector<Type> chunked_vector_out { };
+                sbs::deserialize_using_reader(chunked_vector_out, reader, endian);
+                TEST_ASSERT(vector_in == chunked_vector_out);
+            }
+        };
+
+        std::vector<uint16_t> uint16s(1003);
+        std::vector<uint32_t> uint32s(1003);
+        std::vector<double> doubles(1003);
+        for (size_t i = 0; i < 1003; ++i) {
+            uint16s[i] = static_cast<uint16_t>(i * 40503U);
+            uint32s[i] = static_cast<uint32_t>(i * 2654435761U);
+            doubles[i] = static_cast<double>(i) * -1.25;
+        }
+        test_bulk(uint16s);
+        test_bulk(uint32s);
+        test_bulk(doubles);
+    }
+}